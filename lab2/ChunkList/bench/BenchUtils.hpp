@@ -0,0 +1,131 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace fefu_laboratory_two::bench {
+    template <typename T>
+    inline void DoNotOptimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    class Timer {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        Timer() : started(clock::now()) {}
+
+        double Seconds() const {
+            return std::chrono::duration<double>(clock::now() - started).count();
+        }
+
+    private:
+        clock::time_point started;
+    };
+
+    class CacheMissCounter {
+    public:
+        CacheMissCounter() {
+#ifdef __linux__
+            perf_event_attr attributes{};
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.size = sizeof(attributes);
+            attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+        }
+
+        CacheMissCounter(const CacheMissCounter& other) = delete;
+
+        CacheMissCounter& operator=(const CacheMissCounter& other) = delete;
+
+        ~CacheMissCounter() {
+#ifdef __linux__
+            if (descriptor >= 0) {
+                close(descriptor);
+            }
+#endif
+        }
+
+        bool Available() const noexcept {
+            return descriptor >= 0;
+        }
+
+        void Start() noexcept {
+#ifdef __linux__
+            if (descriptor >= 0) {
+                ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+                ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        long long Stop() noexcept {
+            long long misses = -1;
+#ifdef __linux__
+            if (descriptor >= 0) {
+                ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+                if (read(descriptor, &misses, sizeof(misses)) != sizeof(misses)) {
+                    misses = -1;
+                }
+            }
+#endif
+            return misses;
+        }
+
+    private:
+        int descriptor = -1;
+    };
+
+    inline std::size_t allocated_bytes = 0;
+
+    template <typename T>
+    class CountingAllocator {
+    public:
+        using value_type = T;
+
+        CountingAllocator() noexcept = default;
+
+        template <typename U>
+        CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+        T* allocate(std::size_t count) {
+            allocated_bytes += count * sizeof(T);
+            return std::allocator<T>().allocate(count);
+        }
+
+        void deallocate(T* pointer, std::size_t count) noexcept {
+            allocated_bytes -= count * sizeof(T);
+            std::allocator<T>().deallocate(pointer, count);
+        }
+
+        template <typename U>
+        friend bool operator==(const CountingAllocator&, const CountingAllocator<U>&) noexcept {
+            return true;
+        }
+    };
+
+    inline std::size_t ElementCount(int argc, char** argv, std::size_t fallback) {
+        if (argc > 1) {
+            return std::strtoull(argv[1], nullptr, 10);
+        }
+        return fallback;
+    }
+
+    inline void Report(const std::string& name, std::size_t operations, double seconds) {
+        std::cout << name << ": " << seconds * 1e9 / operations << " ns/op, "
+                  << operations / seconds / 1e6 << " Mop/s" << std::endl;
+    }
+}
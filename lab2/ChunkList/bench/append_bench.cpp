@@ -0,0 +1,30 @@
+#include "../src/ChunkList.hpp"
+#include "BenchUtils.hpp"
+#include <deque>
+#include <vector>
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+template <typename Container>
+void RunAppend(const std::string& name, std::size_t count) {
+    Timer timer;
+    Container container;
+    for (std::size_t i = 0; i < count; i++) {
+        container.push_back(static_cast<int>(i));
+    }
+    DoNotOptimize(container.back());
+    Report(name, count, timer.Seconds());
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = ElementCount(argc, argv, 10'000'000);
+    std::cout << "push_back of " << count << " ints" << std::endl;
+
+    RunAppend<std::vector<int>>("std::vector", count);
+    RunAppend<std::deque<int>>("std::deque", count);
+    RunAppend<ChunkList<int, 64>>("ChunkList<int, 64>", count);
+    RunAppend<ChunkList<int, 1024>>("ChunkList<int, 1024>", count);
+
+    return 0;
+}
@@ -0,0 +1,332 @@
+#include "../src/ChunkList.hpp"
+#include "BenchUtils.hpp"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <list>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+// The whole suite: ChunkList at several chunk sizes against std::vector,
+// std::deque and std::list, for small and wide elements. Every case runs in
+// its own child process so that ru_maxrss is the peak of that case alone.
+// Usage: chunklist_bench [elements] [--json]
+
+template <std::size_t Bytes>
+struct Element {
+    std::array<std::uint32_t, Bytes / sizeof(std::uint32_t)> words{};
+
+    Element() = default;
+
+    explicit Element(std::uint32_t value) noexcept {
+        words[0] = value;
+    }
+
+    std::uint32_t Key() const noexcept {
+        return words[0];
+    }
+};
+
+struct Sample {
+    std::size_t operations = 0;
+    double seconds = 0;
+    long peak_rss_kb = 0;
+};
+
+template <typename Container>
+constexpr bool has_front = requires(Container& container) {
+    container.push_front(container.front());
+    container.pop_front();
+};
+
+template <typename Container>
+constexpr bool has_index = requires(Container& container) {
+    container[0];
+};
+
+template <typename Container>
+std::size_t Size(const Container& container) {
+    if constexpr (requires { container.get_size(); }) {
+        return static_cast<std::size_t>(container.get_size());
+    }
+    else {
+        return container.size();
+    }
+}
+
+template <typename Container>
+Container Build(std::size_t count) {
+    using value_type = typename Container::value_type;
+    Container container;
+    for (std::size_t i = 0; i < count; i++) {
+        container.push_back(value_type(static_cast<std::uint32_t>(i)));
+    }
+    return container;
+}
+
+template <typename Container>
+Sample PushBack(std::size_t count) {
+    Timer timer;
+    Container container = Build<Container>(count);
+    double seconds = timer.Seconds();
+    DoNotOptimize(Size(container));
+    return {count, seconds};
+}
+
+template <typename Container>
+Sample PushFront(std::size_t count) {
+    using value_type = typename Container::value_type;
+    Container container;
+    Timer timer;
+    for (std::size_t i = 0; i < count; i++) {
+        container.push_front(value_type(static_cast<std::uint32_t>(i)));
+    }
+    double seconds = timer.Seconds();
+    DoNotOptimize(Size(container));
+    return {count, seconds};
+}
+
+template <typename Container>
+Sample IndexedRead(std::size_t count) {
+    const Container container = Build<Container>(count);
+    std::mt19937 random(3);
+    std::vector<std::uint32_t> positions(count);
+    for (std::uint32_t& position : positions) {
+        position = static_cast<std::uint32_t>(random() % count);
+    }
+    std::uint64_t checksum = 0;
+    Timer timer;
+    for (std::uint32_t position : positions) {
+        checksum += container[position].Key();
+    }
+    double seconds = timer.Seconds();
+    DoNotOptimize(checksum);
+    return {count, seconds};
+}
+
+template <typename Container>
+Sample Iterate(std::size_t count) {
+    constexpr std::size_t passes = 5;
+    const Container container = Build<Container>(count);
+    std::uint64_t checksum = 0;
+    Timer timer;
+    for (std::size_t pass = 0; pass < passes; pass++) {
+        for (const auto& element : container) {
+            checksum += element.Key();
+        }
+    }
+    double seconds = timer.Seconds();
+    DoNotOptimize(checksum);
+    return {count * passes, seconds};
+}
+
+// Insert then erase at one position in the middle, keeping the iterator each
+// call returns, so std::list does not pay for walking to the middle.
+template <typename Container>
+Sample MiddleInsertErase(std::size_t count) {
+    using value_type = typename Container::value_type;
+    std::size_t rounds = std::min<std::size_t>(count, 1000);
+    Container container = Build<Container>(count);
+    auto middle = std::next(container.begin(), static_cast<std::ptrdiff_t>(count / 2));
+    Timer timer;
+    for (std::size_t i = 0; i < rounds; i++) {
+        middle = container.insert(middle, value_type(static_cast<std::uint32_t>(i)));
+        middle = container.erase(middle);
+    }
+    double seconds = timer.Seconds();
+    DoNotOptimize(Size(container));
+    return {rounds * 2, seconds};
+}
+
+// ChunkList copies share chunks copy-on-write, so this also times the
+// first write to every chunk of the copy, which is when the data moves.
+template <typename Container>
+Sample Copy(std::size_t count) {
+    constexpr std::size_t copies = 5;
+    const Container container = Build<Container>(count);
+    std::uint64_t checksum = 0;
+    Timer timer;
+    for (std::size_t i = 0; i < copies; i++) {
+        Container copy(container);
+        for (auto& element : copy) {
+            element.words[0]++;
+        }
+        checksum += copy.front().Key();
+    }
+    double seconds = timer.Seconds();
+    DoNotOptimize(checksum);
+    return {count * copies, seconds};
+}
+
+template <typename Container>
+Sample Clear(std::size_t count) {
+    Container container = Build<Container>(count);
+    Timer timer;
+    container.clear();
+    double seconds = timer.Seconds();
+    DoNotOptimize(Size(container));
+    return {count, seconds};
+}
+
+// A FIFO in steady state: push_back and pop_front on a short backlog.
+template <typename Container>
+Sample Queue(std::size_t count) {
+    using value_type = typename Container::value_type;
+    Container container = Build<Container>(1024);
+    std::uint64_t checksum = 0;
+    Timer timer;
+    for (std::size_t i = 0; i < count; i++) {
+        container.push_back(value_type(static_cast<std::uint32_t>(i)));
+        checksum += container.front().Key();
+        container.pop_front();
+    }
+    double seconds = timer.Seconds();
+    DoNotOptimize(checksum);
+    return {count * 2, seconds};
+}
+
+template <typename Run>
+std::optional<Sample> Isolated(Run run) {
+    std::cout.flush();
+    int descriptors[2];
+    if (pipe(descriptors) != 0) {
+        return std::nullopt;
+    }
+    pid_t child = fork();
+    if (child == 0) {
+        close(descriptors[0]);
+        Sample sample = run();
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        sample.peak_rss_kb = usage.ru_maxrss;
+        ssize_t written = write(descriptors[1], &sample, sizeof(sample));
+        _exit(written == sizeof(sample) ? 0 : 1);
+    }
+    close(descriptors[1]);
+    Sample sample;
+    bool received = child > 0 && read(descriptors[0], &sample, sizeof(sample)) == sizeof(sample);
+    close(descriptors[0]);
+    if (child > 0) {
+        waitpid(child, nullptr, 0);
+    }
+    if (!received) {
+        return std::nullopt;
+    }
+    return sample;
+}
+
+class Suite {
+public:
+    Suite(std::size_t count, bool json) : count(count), json(json) {}
+
+    template <template <typename> typename Make>
+    void RunAll(std::string_view container) {
+        Run<typename Make<Element<4>>::type>(container, 4);
+        Run<typename Make<Element<64>>::type>(container, 64);
+    }
+
+    void Finish() {
+        if (json) {
+            std::cout << "\n  ]\n}" << std::endl;
+        }
+    }
+
+private:
+    std::size_t count;
+    bool json;
+    bool first = true;
+
+    template <typename Container>
+    void Run(std::string_view container, std::size_t bytes) {
+        Record(container, bytes, "push_back", Isolated([&] { return PushBack<Container>(count); }));
+        if constexpr (has_front<Container>) {
+            Record(container, bytes, "push_front", Isolated([&] { return PushFront<Container>(count); }));
+        }
+        if constexpr (has_index<Container>) {
+            Record(container, bytes, "indexed_read", Isolated([&] { return IndexedRead<Container>(count); }));
+        }
+        Record(container, bytes, "iterate", Isolated([&] { return Iterate<Container>(count); }));
+        Record(container, bytes, "middle_insert_erase", Isolated([&] { return MiddleInsertErase<Container>(count); }));
+        Record(container, bytes, "copy", Isolated([&] { return Copy<Container>(count); }));
+        Record(container, bytes, "clear", Isolated([&] { return Clear<Container>(count); }));
+        if constexpr (has_front<Container>) {
+            Record(container, bytes, "queue", Isolated([&] { return Queue<Container>(count); }));
+        }
+    }
+
+    void Record(std::string_view container, std::size_t bytes, std::string_view workload,
+                const std::optional<Sample>& sample) {
+        if (!sample) {
+            std::cerr << container << ", " << bytes << " B, " << workload << ": failed" << std::endl;
+            return;
+        }
+        double ns_per_op = sample->seconds * 1e9 / sample->operations;
+        double mops = sample->operations / sample->seconds / 1e6;
+        if (!json) {
+            std::cout << container << ", " << bytes << " B, " << workload << ": " << ns_per_op << " ns/op, "
+                      << mops << " Mop/s, " << sample->peak_rss_kb << " KiB peak RSS" << std::endl;
+            return;
+        }
+        std::cout << (first ? "{\n  \"elements\": " + std::to_string(count) + ",\n  \"results\": [\n" : ",\n")
+                  << "    {\"container\": \"" << container << "\", \"element_bytes\": " << bytes
+                  << ", \"workload\": \"" << workload << "\", \"operations\": " << sample->operations
+                  << ", \"ns_per_op\": " << ns_per_op << ", \"mops\": " << mops
+                  << ", \"peak_rss_kb\": " << sample->peak_rss_kb << "}";
+        first = false;
+    }
+};
+
+template <typename T>
+struct MakeVector {
+    using type = std::vector<T>;
+};
+
+template <typename T>
+struct MakeDeque {
+    using type = std::deque<T>;
+};
+
+template <typename T>
+struct MakeList {
+    using type = std::list<T>;
+};
+
+template <int N>
+struct MakeChunkList {
+    template <typename T>
+    struct Make {
+        using type = ChunkList<T, N>;
+    };
+};
+
+int main(int argc, char** argv) {
+    std::size_t count = 200'000;
+    bool json = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::string_view(argv[i]) == "--json") {
+            json = true;
+        }
+        else {
+            count = std::max<std::size_t>(std::strtoull(argv[i], nullptr, 10), 1);
+        }
+    }
+    Suite suite(count, json);
+    suite.RunAll<MakeVector>("std::vector");
+    suite.RunAll<MakeDeque>("std::deque");
+    suite.RunAll<MakeList>("std::list");
+    suite.RunAll<MakeChunkList<64>::Make>("ChunkList<64>");
+    suite.RunAll<MakeChunkList<512>::Make>("ChunkList<512>");
+    suite.RunAll<MakeChunkList<4096>::Make>("ChunkList<4096>");
+    suite.Finish();
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "../src/ChunkList.hpp"
+#include "../src/ColumnarChunkList.hpp"
+#include "../src/SegmentedAlgorithms.hpp"
+#include "BenchUtils.hpp"
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+// A 64-byte record of which the scan reads one 8-byte field.
+struct Trade {
+    long long id;
+    double price;
+    double quantity;
+    double fee;
+    long long account;
+    long long venue;
+    long long time;
+    long long flags;
+};
+
+template <typename Function>
+void Measure(const std::string& name, std::size_t rows, std::size_t bytes, Function function) {
+    constexpr int repeats = 20;
+    double checksum = 0;
+    Timer timer;
+    for (int i = 0; i < repeats; i++) {
+        checksum += function();
+    }
+    double seconds = timer.Seconds();
+    DoNotOptimize(checksum);
+    Report(name, rows * repeats, seconds);
+    std::cout << "    " << bytes * repeats / seconds / 1e9 << " GB/s of layout swept" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::size_t rows = ElementCount(argc, argv, 4'000'000);
+    ChunkList<Trade, 1024> rows_list;
+    ColumnarChunkList<long long, double, double, double, long long, long long, long long, long long> columns;
+    for (std::size_t i = 0; i < rows; i++) {
+        auto value = static_cast<long long>(i);
+        rows_list.push_back({value, value * 0.25, 1.0, 0.0, value % 97, value % 13, value, 0});
+        columns.emplace_back(value, value * 0.25, 1.0, 0.0, value % 97, value % 13, value, 0);
+    }
+    const auto& aos = rows_list;
+    const auto& soa = columns;
+
+    Measure("AoS price sum, scalar", rows, rows * sizeof(Trade), [&] {
+        return fefu_laboratory_two::accumulate(aos, 0.0, [](double sum, const Trade& trade) {
+            return sum + trade.price;
+        });
+    });
+    Measure("SoA price sum, scalar", rows, rows * sizeof(double), [&] {
+        return fefu_laboratory_two::accumulate(soa.column<1>(), 0.0);
+    });
+    Measure("SoA price sum, SIMD", rows, rows * sizeof(double), [&] {
+        return fefu_laboratory_two::sum(soa.column<1>());
+    });
+    Measure("AoS price and quantity", rows, rows * sizeof(Trade), [&] {
+        double total = 0;
+        for (auto segment : aos.segments()) {
+            for (const Trade& trade : segment) {
+                total += trade.price * trade.quantity;
+            }
+        }
+        return total;
+    });
+    Measure("SoA price and quantity", rows, rows * 2 * sizeof(double), [&] {
+        double total = 0;
+        auto prices = soa.column<1>();
+        auto quantities = soa.column<2>();
+        auto quantity = quantities.segments().begin();
+        for (auto price : prices.segments()) {
+            for (std::size_t i = 0; i < price.size(); i++) {
+                total += price[i] * (*quantity)[i];
+            }
+            ++quantity;
+        }
+        return total;
+    });
+    return 0;
+}
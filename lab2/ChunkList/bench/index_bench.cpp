@@ -0,0 +1,33 @@
+#include "../src/ChunkList.hpp"
+#include "BenchUtils.hpp"
+#include <random>
+#include <utility>
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+// Random single-element edits interleaved with random reads, which keeps
+// chunks partly filled and the position index busy.
+int main(int argc, char** argv) {
+    std::size_t operations = ElementCount(argc, argv, 200'000);
+    for (std::size_t count : {1'000'000, 4'000'000, 16'000'000}) {
+        ChunkList<int, 1024> list(count, 0);
+        std::mt19937 random(7);
+        long long checksum = 0;
+        Timer timer;
+        for (std::size_t i = 0; i < operations; i++) {
+            int size = list.get_size();
+            int position = static_cast<int>(random() % size);
+            if (i % 2 == 0) {
+                list.insert(list.cbegin() + position, static_cast<int>(i));
+            }
+            else {
+                list.erase(list.cbegin() + position);
+            }
+            checksum += std::as_const(list)[random() % list.get_size()];
+        }
+        DoNotOptimize(checksum);
+        Report("edit + read, " + std::to_string(count) + " elements", operations, timer.Seconds());
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "../src/ChunkList.hpp"
+#include "BenchUtils.hpp"
+#include <random>
+#include <vector>
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+constexpr int chunk_size = chunk_capacity_for_bytes<long long>;
+
+// The layout ChunkList used before chunks became a single block: a header
+// allocation that points to a separately allocated element buffer.
+struct SplitChunk {
+    virtual ~SplitChunk() = default;
+    int size = chunk_size;
+    int current_size = 0;
+    long long* list = nullptr;
+    SplitChunk* prev = nullptr;
+    SplitChunk* next = nullptr;
+};
+
+struct SplitList {
+    std::vector<SplitChunk*> directory;
+    std::vector<void*> noise;
+
+    explicit SplitList(std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            if (directory.empty() || directory.back()->current_size == chunk_size) {
+                auto* chunk = new SplitChunk();
+                noise.push_back(malloc(96));
+                chunk->list = static_cast<long long*>(malloc(sizeof(long long) * chunk_size));
+                if (!directory.empty()) {
+                    directory.back()->next = chunk;
+                    chunk->prev = directory.back();
+                }
+                directory.push_back(chunk);
+            }
+            SplitChunk* tail = directory.back();
+            tail->list[tail->current_size++] = static_cast<long long>(i);
+        }
+    }
+
+    ~SplitList() {
+        for (SplitChunk* chunk : directory) {
+            free(chunk->list);
+            delete chunk;
+        }
+        for (void* pointer : noise) {
+            free(pointer);
+        }
+    }
+
+    long long& operator[](std::size_t pos) {
+        return directory[pos / chunk_size]->list[pos % chunk_size];
+    }
+};
+
+template <typename Function>
+void Measure(const std::string& name, std::size_t operations, Function function) {
+    CacheMissCounter counter;
+    Timer timer;
+    counter.Start();
+    function();
+    long long misses = counter.Stop();
+    double seconds = timer.Seconds();
+    Report(name, operations, seconds);
+    if (counter.Available()) {
+        std::cout << "    cache misses: " << misses << " (" << static_cast<double>(misses) / operations << " per op)" << std::endl;
+    }
+    else {
+        std::cout << "    cache misses: perf counters unavailable" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = ElementCount(argc, argv, 20'000'000);
+    std::size_t lookups = count / 4;
+    std::cout << "reads over " << count << " long longs, " << chunk_size << " per chunk" << std::endl;
+
+    std::vector<std::size_t> positions(lookups);
+    std::mt19937_64 generator(42);
+    std::uniform_int_distribution<std::size_t> distribution(0, count - 1);
+    for (auto& position : positions) {
+        position = distribution(generator);
+    }
+
+    {
+        SplitList list(count);
+        Measure("split header/buffer, sequential", count, [&] {
+            long long sum = 0;
+            for (SplitChunk* chunk = list.directory.front(); chunk != nullptr; chunk = chunk->next) {
+                for (int i = 0; i < chunk->current_size; i++) {
+                    sum += chunk->list[i];
+                }
+            }
+            DoNotOptimize(sum);
+        });
+        Measure("split header/buffer, random", lookups, [&] {
+            long long sum = 0;
+            for (std::size_t position : positions) {
+                sum += list[position];
+            }
+            DoNotOptimize(sum);
+        });
+    }
+    {
+        ChunkList<long long, chunk_size> list;
+        for (std::size_t i = 0; i < count; i++) {
+            list.push_back(static_cast<long long>(i));
+        }
+        Measure("single block, sequential", count, [&] {
+            long long sum = 0;
+            for (std::span<long long> segment : list.segments()) {
+                for (long long value : segment) {
+                    sum += value;
+                }
+            }
+            DoNotOptimize(sum);
+        });
+        Measure("single block, random", lookups, [&] {
+            long long sum = 0;
+            for (std::size_t position : positions) {
+                sum += list[position];
+            }
+            DoNotOptimize(sum);
+        });
+    }
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "../src/ChunkList.hpp"
+#include "../src/ChunkSerialization.hpp"
+#include "../src/MappedChunkList.hpp"
+#include "BenchUtils.hpp"
+#include <cstdio>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+int main(int argc, char** argv) {
+    std::size_t count = ElementCount(argc, argv, 20'000'000);
+    std::string path = "/tmp/chunklist_mapped_bench_" + std::to_string(getpid());
+    std::string image = path + ".bin";
+    std::cout << count * sizeof(long long) / 1e6 << " MB of elements" << std::endl;
+    {
+        Timer timer;
+        MappedChunkList<long long, 65536> mapped(path);
+        for (std::size_t i = 0; i < count; i++) {
+            mapped->push_back(static_cast<long long>(i));
+        }
+        Report("build in file", count, timer.Seconds());
+        int fd = ::open(image.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        write_binary(fd, std::as_const(*mapped));
+        ::close(fd);
+    }
+    {
+        Timer timer;
+        MappedChunkList<long long, 65536> mapped(path);
+        std::cout << "reopen: " << timer.Seconds() * 1e3 << " ms" << std::endl;
+        for (Advice advice : {Advice::Normal, Advice::Sequential}) {
+            mapped.advise(advice);
+            Timer scan;
+            DoNotOptimize(fefu_laboratory_two::sum(std::as_const(*mapped)));
+            Report(advice == Advice::Normal ? "scan, normal" : "scan, sequential", count, scan.Seconds());
+        }
+    }
+    {
+        Timer timer;
+        ChunkList<long long, 65536> heap;
+        int fd = ::open(image.c_str(), O_RDONLY);
+        read_binary(fd, heap);
+        ::close(fd);
+        std::cout << "read_binary into heap: " << timer.Seconds() * 1e3 << " ms" << std::endl;
+    }
+    std::remove(path.c_str());
+    std::remove(image.c_str());
+    return 0;
+}
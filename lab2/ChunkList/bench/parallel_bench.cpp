@@ -0,0 +1,46 @@
+#include "../src/ChunkList.hpp"
+#include "../src/ParallelAlgorithms.hpp"
+#include "BenchUtils.hpp"
+#include <cmath>
+#include <vector>
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+int main(int argc, char** argv) {
+    std::size_t count = ElementCount(argc, argv, 100'000'000);
+    unsigned max_threads = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 64;
+    ChunkList<float, 4096> list;
+    for (std::size_t i = 0; i < count; i++) {
+        list.push_back(static_cast<float>(i % 1000));
+    }
+    std::cout << count << " floats, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        ThreadPool pool(threads);
+        std::cout << threads << " threads" << std::endl;
+        {
+            Timer timer;
+            parallel::for_each(list, [](float& value) { value = std::sqrt(value); }, pool);
+            Report("  for_each", count, timer.Seconds());
+        }
+        {
+            Timer timer;
+            DoNotOptimize(parallel::reduce(list, 0.0, pool));
+            Report("  reduce", count, timer.Seconds());
+        }
+        {
+            Timer timer;
+            DoNotOptimize(parallel::count_if(list, [](float value) { return value > 10.0f; }, pool));
+            Report("  count_if", count, timer.Seconds());
+        }
+        {
+            std::vector<float> output(count);
+            Timer timer;
+            parallel::transform(list, output.begin(), [](float value) { return value * value; }, pool);
+            Report("  transform", count, timer.Seconds());
+            DoNotOptimize(output.back());
+        }
+    }
+    return 0;
+}
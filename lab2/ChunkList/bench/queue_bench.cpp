@@ -0,0 +1,94 @@
+#include "../src/ChunkList.hpp"
+#include "../src/ChunkQueue.hpp"
+#include "BenchUtils.hpp"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+long long Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The pre-queue pipeline: one ChunkList behind a mutex.
+class LockedList {
+public:
+    void push(long long value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        list.push_back(value);
+    }
+
+    bool try_pop(long long& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (list.empty()) {
+            return false;
+        }
+        value = list.front();
+        list.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    ChunkList<long long, 64> list;
+};
+
+template <typename Push, typename Pop>
+void Run(const std::string& name, unsigned pairs, std::size_t count, Push push, Pop pop) {
+    std::vector<std::vector<long long>> latencies(pairs);
+    std::vector<std::thread> threads;
+    Timer timer;
+    for (unsigned pair = 0; pair < pairs; pair++) {
+        threads.emplace_back([&] {
+            for (std::size_t i = 0; i < count; i++) {
+                push(Now());
+            }
+        });
+        threads.emplace_back([&, pair] {
+            std::vector<long long>& samples = latencies[pair];
+            samples.reserve(count);
+            for (std::size_t i = 0; i < count; i++) {
+                long long stamp = pop();
+                samples.push_back(Now() - stamp);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = timer.Seconds();
+    std::vector<long long> all;
+    for (auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+    auto percentile = [&](double fraction) {
+        return all[std::min(all.size() - 1, static_cast<std::size_t>(fraction * all.size()))];
+    };
+    Report(name + " " + std::to_string(pairs) + "P/" + std::to_string(pairs) + "C", pairs * count, seconds);
+    std::cout << "  latency p50 " << percentile(0.5) << " ns, p99 " << percentile(0.99) << " ns, p99.9 "
+              << percentile(0.999) << " ns" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = ElementCount(argc, argv, 1'000'000);
+    for (unsigned pairs : {1u, 2u, 4u}) {
+        ChunkQueue<long long, 256> queue(4096);
+        Run("ChunkQueue", pairs, count, [&](long long value) { queue.push(value); }, [&] { return queue.pop(); });
+
+        LockedList locked;
+        Run("mutex + ChunkList", pairs, count, [&](long long value) { locked.push(value); }, [&] {
+            long long value;
+            while (!locked.try_pop(value)) {
+                std::this_thread::yield();
+            }
+            return value;
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include "../src/ChunkList.hpp"
+#include "../src/ChunkSerialization.hpp"
+#include "BenchUtils.hpp"
+#include <cstdio>
+#include <vector>
+#include <unistd.h>
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+template <typename Function>
+void Measure(const std::string& name, std::size_t bytes, Function function) {
+    constexpr int passes = 5;
+    Timer timer;
+    for (int pass = 0; pass < passes; pass++) {
+        function();
+    }
+    std::cout << name << ": " << bytes * passes / timer.Seconds() / 1e9 << " GB/s" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = ElementCount(argc, argv, 16'000'000);
+    ChunkList<long long, 1024> list;
+    for (std::size_t i = 0; i < count; i++) {
+        list.push_back(static_cast<long long>(i * 2654435761u));
+    }
+    std::size_t bytes = count * sizeof(long long);
+    char path[] = "/tmp/chunklist_serialize_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        std::perror("mkstemp");
+        return 1;
+    }
+    unlink(path);
+    std::cout << bytes / 1e6 << " MB payload" << std::endl;
+
+    auto rewind = [&] {
+        lseek(fd, 0, SEEK_SET);
+        DoNotOptimize(ftruncate(fd, 0));
+    };
+    Measure("element-wise copy + write", bytes, [&] {
+        rewind();
+        std::vector<long long> buffer;
+        buffer.reserve(count);
+        for (long long value : list) {
+            buffer.push_back(value);
+        }
+        DoNotOptimize(::write(fd, buffer.data(), buffer.size() * sizeof(long long)));
+    });
+    Measure("write_binary", bytes, [&] {
+        rewind();
+        write_binary(fd, list);
+    });
+    Measure("write_binary + checksum", bytes, [&] {
+        rewind();
+        write_binary(fd, list, true);
+    });
+
+    ChunkList<long long, 1024> copy;
+    Measure("read_binary + checksum", bytes, [&] {
+        lseek(fd, 0, SEEK_SET);
+        read_binary(fd, copy);
+    });
+    rewind();
+    write_binary(fd, list);
+    Measure("read_binary", bytes, [&] {
+        lseek(fd, 0, SEEK_SET);
+        read_binary(fd, copy);
+    });
+    Measure("round trip", bytes, [&] {
+        rewind();
+        write_binary(fd, list);
+        lseek(fd, 0, SEEK_SET);
+        read_binary(fd, copy);
+    });
+    close(fd);
+    return copy == list ? 0 : 1;
+}
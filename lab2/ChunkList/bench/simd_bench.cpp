@@ -0,0 +1,40 @@
+#include "../src/ChunkList.hpp"
+#include "BenchUtils.hpp"
+#include <algorithm>
+#include <numeric>
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+template <typename Function>
+void Measure(const std::string& name, std::size_t count, Function function) {
+    constexpr int passes = 20;
+    Timer timer;
+    for (int pass = 0; pass < passes; pass++) {
+        DoNotOptimize(function());
+    }
+    Report(name, count * passes, timer.Seconds());
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = ElementCount(argc, argv, 10'000'000);
+    ChunkList<int, 1024> list;
+    for (std::size_t i = 0; i < count; i++) {
+        list.push_back(static_cast<int>((i * 2654435761u) % 100000));
+    }
+    const char* isa[] = {"scalar", "avx2", "avx512"};
+    std::cout << count << " ints, dispatch: " << isa[static_cast<int>(simd::ActiveIsa())] << std::endl;
+
+    Measure("std::count over iterators", count, [&] { return std::count(list.begin(), list.end(), -1); });
+    Measure("count", count, [&] { return fefu_laboratory_two::count(list, -1); });
+    Measure("std::find over iterators", count, [&] { return std::find(list.begin(), list.end(), -1) == list.end(); });
+    Measure("find", count, [&] { return fefu_laboratory_two::find(list, -1) == list.end(); });
+    Measure("std::accumulate over iterators", count, [&] { return std::accumulate(list.begin(), list.end(), 0LL); });
+    Measure("sum", count, [&] { return fefu_laboratory_two::sum(list); });
+    Measure("std::min_element over iterators", count, [&] { return *std::min_element(list.begin(), list.end()); });
+    Measure("min", count, [&] { return fefu_laboratory_two::min(list); });
+
+    ChunkList<int, 1024> copy = list;
+    Measure("operator==", count, [&] { return list == copy; });
+    return 0;
+}
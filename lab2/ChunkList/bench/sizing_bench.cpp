@@ -0,0 +1,49 @@
+#include "../src/ChunkList.hpp"
+#include "BenchUtils.hpp"
+#include <vector>
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+template <int N>
+using CountedList = ChunkList<int, N, CountingAllocator<int>>;
+
+template <typename List, typename... Args>
+void Run(const std::string& name, std::size_t count, Args&&... args) {
+    std::size_t before = allocated_bytes;
+    List list(std::forward<Args>(args)...);
+    for (std::size_t i = 0; i < count; i++) {
+        list.push_back(static_cast<int>(i));
+    }
+    std::size_t payload = count * sizeof(int);
+    std::size_t used = allocated_bytes - before;
+    std::cout << name << ": " << used << " bytes, " << list.get_chunk_count() << " chunks, overhead "
+              << 100.0 * (static_cast<double>(used) - payload) / payload << "%" << std::endl;
+
+    std::size_t passes = std::max<std::size_t>(1, 100'000'000 / count);
+    Timer timer;
+    long long sum = 0;
+    for (std::size_t pass = 0; pass < passes; pass++) {
+        for (int value : list) {
+            sum += value;
+        }
+        DoNotOptimize(sum);
+    }
+    Report("  scan", passes * count, timer.Seconds());
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::size_t> counts = {16, 1'000, 1'000'000};
+    if (argc > 1) {
+        counts = {ElementCount(argc, argv, 0)};
+    }
+    for (std::size_t count : counts) {
+        std::cout << count << " ints" << std::endl;
+        Run<CountedList<64>>("ChunkList<int, 64>", count);
+        Run<CountedList<1024>>("ChunkList<int, 1024>", count);
+        Run<CountedList<dynamic_chunk_size>>("ChunkList<int, dynamic> 64", count, ChunkSizing(64));
+        Run<CountedList<dynamic_chunk_size>>("ChunkList<int, dynamic> geometric 16..4096", count,
+                                             ChunkSizing::Geometric(16, 4096));
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include "../src/ChunkList.hpp"
+#include "BenchUtils.hpp"
+#include <random>
+#include <vector>
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+// Many short lists, as in hash buckets or adjacency lists: most of them fit
+// in the first chunk, so an inline chunk saves an allocation per list.
+template <bool InlineFirst>
+void Run(const std::string& name, std::size_t lists) {
+    using Bucket = ChunkList<int, 8, CountingAllocator<int>, true, InlineFirst>;
+    std::mt19937 random(11);
+    std::size_t before = allocated_bytes;
+    long long checksum = 0;
+    std::size_t elements = 0;
+    Timer timer;
+    {
+        std::vector<Bucket> buckets(lists);
+        for (Bucket& bucket : buckets) {
+            int length = static_cast<int>(random() % 12);
+            for (int i = 0; i < length; i++) {
+                bucket.push_back(i);
+            }
+            elements += length;
+        }
+        std::size_t used = allocated_bytes - before;
+        for (const Bucket& bucket : buckets) {
+            for (int value : bucket) {
+                checksum += value;
+            }
+        }
+        DoNotOptimize(checksum);
+        std::cout << name << ": " << used / lists << " heap bytes/list" << std::endl;
+    }
+    Report(name + ", build + scan + destroy", elements, timer.Seconds());
+}
+
+int main(int argc, char** argv) {
+    std::size_t lists = ElementCount(argc, argv, 200'000);
+    Run<false>("pooled first chunk", lists);
+    Run<true>("inline first chunk", lists);
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include "../src/ChunkList.hpp"
+#include "BenchUtils.hpp"
+#include <utility>
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+template <typename Function>
+void Measure(const std::string& name, int snapshots, Function function) {
+    Timer timer;
+    for (int i = 0; i < snapshots; i++) {
+        function();
+    }
+    Report(name, snapshots, timer.Seconds());
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = ElementCount(argc, argv, 1'000'000);
+    ChunkList<long long, 1024> list;
+    for (std::size_t i = 0; i < count; i++) {
+        list.push_back(static_cast<long long>(i));
+    }
+    const ChunkList<long long, 1024>& view = list;
+    std::cout << count << " elements in " << list.get_chunk_count() << " chunks" << std::endl;
+
+    Measure("deep copy", 50, [&] {
+        ChunkList<long long, 1024> copy(view.begin(), view.end());
+        DoNotOptimize(copy.get_size());
+    });
+    Measure("snapshot", 50, [&] {
+        ChunkList<long long, 1024> snapshot = list;
+        DoNotOptimize(snapshot.get_size());
+    });
+    Measure("snapshot + sum", 50, [&] {
+        ChunkList<long long, 1024> snapshot = list;
+        DoNotOptimize(fefu_laboratory_two::sum(std::as_const(snapshot)));
+    });
+    Measure("snapshot + find", 50, [&] {
+        ChunkList<long long, 1024> snapshot = list;
+        DoNotOptimize(*fefu_laboratory_two::find(snapshot, static_cast<long long>(count / 2)));
+    });
+    Measure("snapshot + write through an iterator", 50, [&] {
+        ChunkList<long long, 1024> snapshot = list;
+        (*snapshot.nth(count / 2))++;
+        DoNotOptimize(snapshot.get_size());
+    });
+    Measure("snapshot + one write to the source", 50, [&] {
+        ChunkList<long long, 1024> snapshot = list;
+        list[count / 2]++;
+        DoNotOptimize(snapshot.get_size());
+    });
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include "../src/ChunkSort.hpp"
+#include "BenchUtils.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace fefu_laboratory_two;
+using namespace fefu_laboratory_two::bench;
+
+struct Record {
+    unsigned long long key;
+    long long payload[3];
+};
+
+long long comparisons = 0;
+
+struct CountingLess {
+    bool operator()(const Record& first, const Record& second) const noexcept {
+        comparisons++;
+        return first.key < second.key;
+    }
+};
+
+using List = ChunkList<Record, 1024>;
+
+template <typename Function>
+void Measure(const std::string& name, const std::vector<Record>& input, Function function) {
+    List list(input.begin(), input.end());
+    std::vector<Record> vector = input;
+    comparisons = 0;
+    Timer timer;
+    function(list, vector);
+    double seconds = timer.Seconds();
+    Report(name, input.size(), seconds);
+    if (comparisons > 0) {
+        std::cout << "    " << static_cast<double>(comparisons) / input.size() << " comparisons per element" << std::endl;
+    }
+}
+
+// Sorting random records, the way the nightly reorder does it: in place
+// with the chunked sort, or through a vector and back.
+int main(int argc, char** argv) {
+    std::size_t count = ElementCount(argc, argv, 4'000'000);
+    std::mt19937_64 random(22);
+    std::vector<Record> input(count);
+    for (Record& record : input) {
+        record.key = random();
+    }
+    Measure("std::sort on vector", input, [](List&, std::vector<Record>& vector) {
+        std::sort(vector.begin(), vector.end(), CountingLess());
+    });
+    Measure("copy to vector, std::sort, copy back", input, [](List& list, std::vector<Record>&) {
+        std::vector<Record> vector(list.begin(), list.end());
+        std::sort(vector.begin(), vector.end(), CountingLess());
+        std::copy(vector.begin(), vector.end(), list.begin());
+    });
+    Measure("chunked sort", input, [](List& list, std::vector<Record>&) {
+        fefu_laboratory_two::sort(list, CountingLess());
+    });
+    Measure("chunked stable_sort", input, [](List& list, std::vector<Record>&) {
+        fefu_laboratory_two::stable_sort(list, CountingLess());
+    });
+    Measure("chunked partial_sort, first 1000", input, [](List& list, std::vector<Record>&) {
+        fefu_laboratory_two::partial_sort(list, 1000, CountingLess());
+    });
+    // Comparisons from several threads are not counted.
+    Measure("parallel chunked sort", input, [](List& list, std::vector<Record>&) {
+        fefu_laboratory_two::parallel::sort(list, [](const Record& first, const Record& second) {
+            return first.key < second.key;
+        });
+    });
+    if (count <= 1'000'000) {
+        Measure("std::sort over ChunkList iterators", input, [](List& list, std::vector<Record>&) {
+            std::sort(list.begin(), list.end(), CountingLess());
+        });
+    }
+    return 0;
+}
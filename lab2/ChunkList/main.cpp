@@ -1,6 +1,29 @@
 #include "src/ChunkList.hpp"
+#include "src/ChunkQueue.hpp"
+#include "src/ChunkSerialization.hpp"
+#include "src/ChunkSort.hpp"
+#include "src/ColumnarChunkList.hpp"
+#include "src/ConcurrentAppender.hpp"
+#include "src/MappedChunkList.hpp"
+#include "src/ParallelAlgorithms.hpp"
+#include "src/SegmentedAlgorithms.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace fefu_laboratory_two;
 
@@ -172,7 +195,1382 @@ int main() {
         assert(list[list.get_size() - 1] == 8);
     }
 
+    {
+        ChunkList<int, 3> list;
+
+        for (int i = 0; i < 10; i++)
+            list.push_back(i);
+
+        assert(list.get_chunk_count() == 4);
+        assert(list.back() == 9);
+
+        for (int i = 9; i >= 1; i--) {
+            assert(list.back() == i);
+            list.pop_back();
+        }
+        assert(list.get_size() == 1);
+        assert(list.get_chunk_count() == 1);
+        assert(list.back() == 0);
+
+        list.push_back(42);
+        assert(list.back() == 42);
+        assert(list[1] == 42);
+    }
+    {
+        ChunkList<int, 3> first_list;
+        ChunkList<int, 3> second_list;
+
+        for (int i = 0; i < 7; i++)
+            first_list.push_back(i);
+        second_list.push_back(100);
+
+        first_list.swap(second_list);
+        assert(first_list.back() == 100);
+        assert(second_list.back() == 6);
+        assert(second_list.get_chunk_count() == 3);
+
+        ChunkList<int, 3> moved(std::move(second_list));
+        assert(moved.back() == 6);
+        assert(moved.get_size() == 7);
+        assert(second_list.empty());
+
+        second_list.push_back(5);
+        assert(second_list.back() == 5);
+
+        moved.clear();
+        assert(moved.get_chunk_count() == 0);
+        moved.push_back(1);
+        assert(moved.back() == 1);
+        assert(moved.front() == 1);
+    }
+    {
+        ChunkList<int, 3> list;
+
+        for (int i = 0; i < 7; i++)
+            list.push_back(i);
+
+        list.erase(list.cbegin());
+        assert(list.get_size() == 6);
+        assert(list.get_chunk_count() == 3);
+        assert(list.front() == 1);
+        assert(list.back() == 6);
+
+        list.push_front(0);
+        assert(list.front() == 0);
+        assert(list.back() == 6);
+        assert(list.get_chunk_count() == 3);
+    }
+    {
+        ChunkList<int, 4> list;
+        ChunkList<int, 4, Allocator<int>, false> compact_list;
+
+        for (int i = 0; i < 100; i++) {
+            list.push_back(i);
+            compact_list.push_back(i);
+        }
+        for (int i = 0; i < 30; i++) {
+            list.pop_back();
+            compact_list.pop_back();
+        }
+
+        for (int i = 0; i < 70; i++) {
+            assert(list[i] == i);
+            assert(list.at(i) == i);
+            assert(compact_list[i] == i);
+        }
+        bool thrown = false;
+        try {
+            list.at(70);
+        }
+        catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown);
+        assert(sizeof(compact_list) < sizeof(list));
+    }
+    {
+        static_assert(std::random_access_iterator<ChunkList<int, 4>::iterator>);
+        static_assert(std::random_access_iterator<ChunkList<int, 4>::const_iterator>);
+
+        ChunkList<int, 4> list;
+
+        for (int i = 0; i < 23; i++)
+            list.push_back((i * 7) % 23);
+
+        std::sort(list.begin(), list.end());
+        for (int i = 0; i < 23; i++)
+            assert(list[i] == i);
+
+        auto found = std::lower_bound(list.begin(), list.end(), 17);
+        assert(found - list.begin() == 17);
+        assert(*found == 17);
+
+        auto last = list.end();
+        --last;
+        assert(*last == 22);
+        assert(last[-5] == 17);
+        assert(list.begin()[9] == 9);
+        assert(*(list.end() - 23) == 0);
+        assert(list.end() - list.begin() == 23);
+
+        const ChunkList<int, 4>& const_list = list;
+        int sum = 0;
+        for (const int& value : const_list)
+            sum += value;
+        assert(sum == 22 * 23 / 2);
+    }
+    {
+        ChunkList<int, 4> list;
+        ChunkList<int, 3> other_list;
+
+        for (int i = 0; i < 10; i++) {
+            list.push_back(i);
+            other_list.push_back(i);
+        }
+
+        std::size_t segment_count = 0;
+        for (std::span<int> segment : list.segments()) {
+            assert(segment.size() == (segment_count < 2 ? 4 : 2));
+            segment_count++;
+        }
+        assert(segment_count == 3);
+
+        assert(fefu_laboratory_two::accumulate(list, 0) == 45);
+        assert(fefu_laboratory_two::count(list, 7) == 1);
+        assert(*fefu_laboratory_two::find(list, 6) == 6);
+        assert(fefu_laboratory_two::find(list, 6) - list.begin() == 6);
+        assert(fefu_laboratory_two::find(list, 60) == list.end());
+        assert(fefu_laboratory_two::equal(list, other_list));
+
+        std::vector<int> copied;
+        fefu_laboratory_two::copy(list, std::back_inserter(copied));
+        assert(copied.size() == 10 && copied[9] == 9);
+
+        fefu_laboratory_two::for_each(list, [](int& value) { value *= 2; });
+        assert(list[5] == 10);
+        assert(!fefu_laboratory_two::equal(list, other_list));
+
+        fefu_laboratory_two::fill(other_list, 1);
+        assert(fefu_laboratory_two::count(other_list, 1) == 10);
+    }
+    {
+        ChunkList<int, 4> list;
+
+        for (int round = 0; round < 3; round++) {
+            for (int i = 0; i < 16; i++)
+                list.push_back(i);
+            while (!list.empty())
+                list.pop_back();
+        }
+
+        ChunkPool<int>& pool = list.get_chunk_pool();
+        assert(pool.GetCached() <= pool.GetHighWaterMark());
+        assert(pool.GetHits() > 0);
+        assert(pool.GetHits() == 6);
+        assert(pool.GetMisses() == 4);
+
+        pool.SetHighWaterMark(0);
+        assert(pool.GetCached() == 0);
+    }
+    {
+        ChunkPool<int> shared_pool(8);
+        {
+            ChunkList<int, 4> list;
+            list.set_chunk_pool(&shared_pool);
+            for (int i = 0; i < 32; i++)
+                list.push_back(i);
+        }
+        assert(shared_pool.GetCached() == 8);
+
+        ChunkList<int, 4> other_list;
+        other_list.set_chunk_pool(&shared_pool);
+        for (int i = 0; i < 32; i++)
+            other_list.push_back(i);
+        assert(shared_pool.GetHits() == 8);
+        assert(other_list[31] == 31);
+        other_list.clear();
+        assert(shared_pool.GetCached() == 8);
+
+        ChunkList<int, 4> local_list;
+        local_list.set_chunk_pool(&ChunkPool<int>::ThreadLocal());
+        local_list.push_back(1);
+        assert(&local_list.get_chunk_pool() == &ChunkPool<int>::ThreadLocal());
+
+        other_list.push_back(7);
+        other_list = local_list;
+        assert(&other_list.get_chunk_pool() == &shared_pool && other_list.front() == 1);
+        other_list = ChunkList<int, 4>(3, 5);
+        assert(&other_list.get_chunk_pool() == &shared_pool && other_list.back() == 5);
+        other_list.swap(local_list);
+        assert(&other_list.get_chunk_pool() == &shared_pool && other_list.front() == 1);
+        assert(&local_list.get_chunk_pool() == &ChunkPool<int>::ThreadLocal() && local_list.get_size() == 3);
+        ChunkList<int, 4> moved(std::move(local_list));
+        assert(&moved.get_chunk_pool() == &ChunkPool<int>::ThreadLocal());
+    }
+    {
+        struct CountingResource : std::pmr::memory_resource {
+            std::size_t allocations = 0;
+            std::size_t deallocations = 0;
 
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                allocations++;
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+                deallocations++;
+                std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+
+        CountingResource resource;
+        {
+            pmr::ChunkList<int, 4> list(&resource);
+            for (int i = 0; i < 40; i++)
+                list.push_back(i);
+            assert(list.get_allocator().resource() == &resource);
+            assert(resource.allocations >= 10);
+
+            pmr::ChunkList<int, 4> moved(std::move(list));
+            assert(moved.get_allocator().resource() == &resource);
+            assert(moved[39] == 39);
+
+            pmr::ChunkList<int, 4> other(std::pmr::new_delete_resource());
+            other = moved;
+            assert(other.get_allocator().resource() == std::pmr::new_delete_resource());
+            assert(other[39] == 39);
+
+            other = std::move(moved);
+            assert(other.get_allocator().resource() == std::pmr::new_delete_resource());
+            assert(other[39] == 39);
+            assert(moved.empty());
+        }
+        assert(resource.allocations == resource.deallocations);
+    }
+    {
+        ChunkArena<16 * 1024> arena(std::pmr::null_memory_resource());
+        pmr::ChunkList<int, 16> list(&arena);
+
+        for (int i = 0; i < 1000; i++)
+            list.push_back(i);
+        assert(list[999] == 999);
+        assert(list.get_chunk_count() == 63);
+    }
+    {
+        struct alignas(128) Wide {
+            int value = 0;
+        };
+
+        static_assert(sizeof(Chunk<int>) == 64);
+        static_assert(Chunk<int>::BlockCount(chunk_capacity_for_bytes<int>) * 64 == 4096);
+
+        ChunkList<int, chunk_capacity_for_bytes<int>> list;
+        ChunkList<Wide, 3> wide_list;
+
+        for (int i = 0; i < 5000; i++)
+            list.push_back(i);
+        for (int i = 0; i < 10; i++)
+            wide_list.push_back(Wide{i});
+
+        for (std::span<int> segment : list.segments())
+            assert(reinterpret_cast<std::uintptr_t>(segment.data()) % 64 == 0);
+        for (int i = 0; i < 10; i++) {
+            assert(reinterpret_cast<std::uintptr_t>(&wide_list[i]) % 128 == 0);
+            assert(wide_list[i].value == i);
+        }
+        assert(list[4999] == 4999);
+    }
+    {
+        static int alive = 0;
+        struct Tracked {
+            int value;
+
+            explicit Tracked(int value) : value(value) { alive++; }
+            Tracked(const Tracked& other) : value(other.value) { alive++; }
+            Tracked(Tracked&& other) noexcept : value(other.value) { alive++; }
+            Tracked& operator=(const Tracked& other) = default;
+            Tracked& operator=(Tracked&& other) noexcept = default;
+            ~Tracked() { alive--; }
+        };
+
+        {
+            ChunkList<Tracked, 3> list;
+            for (int i = 0; i < 10; i++)
+                list.emplace_back(i);
+            assert(alive == 10);
+
+            list.emplace(list.cbegin() + 4, 100);
+            list.emplace_front(-1);
+            assert(alive == 12);
+            assert(list[0].value == -1);
+            assert(list[5].value == 100);
+            assert(list[11].value == 9);
+
+            list.erase(list.cbegin() + 5);
+            list.pop_back();
+            assert(alive == 10);
+            assert(list[5].value == 4);
+
+            ChunkList<Tracked, 3> copy = list;
+            assert(alive == 10);
+            copy.erase(copy.cbegin(), copy.cbegin() + 4);
+            assert(copy[0].value == 3 && copy.get_size() == 6);
+            assert(std::as_const(list)[0].value == -1 && list.get_size() == 10);
+        }
+        assert(alive == 0);
+    }
+    {
+        ChunkList<std::string, 2> strings;
+        for (int i = 0; i < 6; i++)
+            strings.push_back(std::string(40, static_cast<char>('a' + i)));
+        strings.insert(strings.cbegin() + 1, "inserted");
+        assert(strings[1] == "inserted");
+        assert(strings[6] == std::string(40, 'f'));
+
+        ChunkList<std::unique_ptr<int>, 4> owners;
+        for (int i = 0; i < 9; i++)
+            owners.emplace_back(std::make_unique<int>(i));
+        owners.emplace(owners.cbegin() + 2, std::make_unique<int>(42));
+        owners.erase(owners.cbegin());
+        assert(*owners[1] == 42);
+        assert(*owners.back() == 8);
+    }
+    {
+        ChunkList<int, 5> list(12, 7);
+        for (int i = 0; i < 12; i++)
+            list[i] = i;
+
+        list.insert(list.cbegin() + 3, 100);
+        list.erase(list.cbegin() + 8, list.cbegin() + 11);
+        int expected[] = {0, 1, 2, 100, 3, 4, 5, 6, 10, 11};
+        assert(list.get_size() == 10);
+        for (int i = 0; i < 10; i++)
+            assert(list[i] == expected[i]);
+    }
+    {
+        ChunkList<int, 8> list;
+
+        for (int i = 0; i < 64; i++)
+            list.push_back(i);
+        assert(list.get_chunk_count() == 8);
+
+        list.insert(list.cbegin() + 20, -1);
+        assert(list.get_chunk_count() == 9);
+        assert(list[20] == -1);
+        assert(list[21] == 20);
+        assert(list[64] == 63);
+
+        list.erase(list.cbegin() + 16, list.cbegin() + 22);
+        assert(list[16] == 21);
+        assert(list.get_size() == 59);
+        for (int i = 0; i < 16; i++)
+            assert(list[i] == i);
+        for (int i = 16; i < 59; i++)
+            assert(list[i] == i + 5);
+    }
+    {
+        ChunkList<int, 6> list;
+        ChunkList<int, 6, Allocator<int>, false> compact_list;
+        std::vector<int> expected;
+        unsigned state = 12345;
+
+        for (int step = 0; step < 3000; step++) {
+            state = state * 1103515245 + 12345;
+            int pos = expected.empty() ? 0 : static_cast<int>((state >> 8) % (expected.size() + 1));
+            if ((state >> 4) % 3 != 0 || expected.empty()) {
+                list.insert(list.cbegin() + pos, step);
+                compact_list.insert(compact_list.cbegin() + pos, step);
+                expected.insert(expected.begin() + pos, step);
+            }
+            else {
+                pos = pos % static_cast<int>(expected.size());
+                list.erase(list.cbegin() + pos);
+                compact_list.erase(compact_list.cbegin() + pos);
+                expected.erase(expected.begin() + pos);
+            }
+        }
+
+        assert(list.get_size() == static_cast<int>(expected.size()));
+        for (std::size_t i = 0; i < expected.size(); i++) {
+            assert(list[i] == expected[i]);
+            assert(compact_list[i] == expected[i]);
+        }
+        assert(std::equal(list.begin(), list.end(), expected.begin()));
+        assert(list.get_chunk_count() <= expected.size() / 3 + 2);
+    }
+    {
+        std::vector<int> source(25);
+        for (int i = 0; i < 25; i++)
+            source[i] = i;
+
+        ChunkList<int, 4> list(source.begin(), source.end());
+        assert(list.get_size() == 25);
+        assert(list.get_chunk_count() == 7);
+        assert(fefu_laboratory_two::equal(list, ChunkList<int, 7>(source.begin(), source.end())));
+
+        ChunkList<int, 4> small_list{1, 2, 3};
+        assert(small_list.get_size() == 3 && small_list[2] == 3);
+
+        list.insert(list.cbegin() + 6, {100, 101, 102, 103, 104, 105});
+        assert(list.get_size() == 31);
+        assert(list[5] == 5 && list[6] == 100 && list[11] == 105 && list[12] == 6);
+        assert(list.back() == 24);
+
+        list.insert_range(list.cbegin(), std::vector<int>{-2, -1});
+        assert(list.front() == -2 && list[2] == 0);
+
+        list.append_range(std::vector<int>{200, 201});
+        assert(list.back() == 201);
+        assert(list.get_size() == 35);
+
+        std::istringstream stream("7 8 9");
+        list.insert(list.cbegin() + 3, std::istream_iterator<int>(stream), std::istream_iterator<int>());
+        assert(list[2] == 0 && list[3] == 7 && list[5] == 9 && list[6] == 1);
+
+        list.assign(source.begin() + 20, source.end());
+        assert(list.get_size() == 5 && list.front() == 20);
+
+        list.assign({4, 5});
+        assert(list.get_size() == 2 && list.back() == 5);
+
+        ChunkList<std::string, 3> strings{"a", "b", "c", "d"};
+        strings.insert(strings.cbegin() + 1, {"x", "y"});
+        assert(strings[1] == "x" && strings[3] == "b" && strings.get_size() == 6);
+    }
+    {
+        ChunkPool<int> pool(128);
+        ChunkList<int, 8> first;
+        ChunkList<int, 8> second;
+        first.set_chunk_pool(&pool);
+        second.set_chunk_pool(&pool);
+        for (int i = 0; i < 800; i++)
+            first.push_back(i);
+        first.clear();
+        assert(pool.GetCached() == 100 && second.capacity() == 0);
+        second.reserve(800);
+        assert(second.capacity() == 800 && pool.GetCached() == 100);
+        for (int i = 0; i < 800; i++)
+            first.push_back(i);
+        std::size_t misses = pool.GetMisses();
+        for (int i = 0; i < 800; i++)
+            second.push_back(i);
+        assert(pool.GetMisses() == misses && second.capacity() == 800 && second[799] == 799);
+    }
+    {
+        ChunkList<int, 8> list;
+        assert(list.capacity() == 0);
+        list.reserve(100);
+        assert(list.capacity() >= 100);
+        std::size_t misses = list.get_chunk_pool().GetMisses();
+        for (int i = 0; i < 100; i++)
+            list.push_back(i);
+        assert(list.get_chunk_pool().GetMisses() == misses);
+        assert(list.capacity() >= static_cast<std::size_t>(list.get_size()));
+        assert(list.max_size() >= 100);
+
+        for (int i = 90; i > 0; i -= 3)
+            list.erase(list.cbegin() + i);
+        assert(list.get_size() == 70);
+        list.shrink_to_fit();
+        assert(list.get_chunk_count() == 9);
+        assert(list.get_chunk_pool().GetCached() == 0);
+        assert(list.capacity() == 72);
+        assert(list[0] == 0 && list[1] == 1 && list[2] == 2 && list[3] == 4);
+        assert(list.back() == 99);
+        int previous = -1;
+        for (int value : list) {
+            assert(value > previous);
+            previous = value;
+        }
+
+        ChunkList<std::string, 4> strings;
+        for (int i = 0; i < 20; i++)
+            strings.push_back(std::to_string(i));
+        for (int i = 0; i < 8; i++)
+            strings.erase(strings.cbegin() + 2);
+        strings.shrink_to_fit();
+        assert(strings.get_chunk_count() == 3);
+        assert(strings[1] == "1" && strings[2] == "10" && strings.back() == "19");
+    }
+    {
+        ChunkList<int, 4> queue;
+        for (int i = 0; i < 10; i++)
+            queue.push_back(i);
+        for (int i = 0; i < 6; i++)
+            queue.pop_front();
+        assert(queue.get_size() == 4 && queue.front() == 6 && queue[3] == 9);
+        for (int i = 1; i <= 9; i++)
+            queue.push_front(-i);
+        assert(queue.front() == -9 && queue[8] == -1 && queue[9] == 6);
+        assert(queue.get_chunk_count() == 4);
+        assert(*(queue.begin() + 5) == -4 && queue.end() - queue.begin() == 13);
+
+        std::deque<int> expected(queue.begin(), queue.end());
+        unsigned state = 7;
+        for (int step = 0; step < 5000; step++) {
+            state = state * 1103515245 + 12345;
+            unsigned action = (state >> 16) % 7;
+            int value = static_cast<int>(state % 1000);
+            if (action == 0 || expected.size() < 4) {
+                queue.push_front(value);
+                expected.push_front(value);
+            }
+            else if (action == 1) {
+                queue.push_back(value);
+                expected.push_back(value);
+            }
+            else if (action == 2) {
+                queue.pop_front();
+                expected.pop_front();
+            }
+            else if (action == 3) {
+                queue.pop_back();
+                expected.pop_back();
+            }
+            else if (action == 4) {
+                int index = value % static_cast<int>(expected.size());
+                queue.insert(queue.cbegin() + index, value);
+                expected.insert(expected.begin() + index, value);
+            }
+            else if (action == 5) {
+                int index = value % static_cast<int>(expected.size());
+                queue.erase(queue.cbegin() + index);
+                expected.erase(expected.begin() + index);
+            }
+            else {
+                int index = value % static_cast<int>(expected.size());
+                assert(queue[index] == expected[index]);
+            }
+        }
+        assert(std::equal(queue.begin(), queue.end(), expected.begin(), expected.end()));
+        queue.shrink_to_fit();
+        assert(std::equal(queue.begin(), queue.end(), expected.begin(), expected.end()));
+
+        ChunkList<std::string, 3, Allocator<std::string>, false> strings;
+        strings.push_back("b");
+        strings.emplace_front("a");
+        strings.push_front("z");
+        strings.pop_back();
+        assert(strings.get_size() == 2 && strings[0] == "z" && strings[1] == "a");
+        strings.pop_front();
+        strings.pop_front();
+        assert(strings.empty());
+        strings.push_back("c");
+        assert(strings.front() == "c" && strings.get_chunk_count() == 1);
+    }
+    {
+        ChunkList<int, dynamic_chunk_size> runtime_list(ChunkSizing(10));
+        for (int i = 0; i < 35; i++)
+            runtime_list.push_back(i);
+        assert(runtime_list.get_chunk_count() == 4);
+        assert(runtime_list[34] == 34 && runtime_list.capacity() == 40);
+
+        ChunkList<int, dynamic_chunk_size> list(ChunkSizing::Geometric(4, 32));
+        for (int i = 0; i < 200; i++)
+            list.push_back(i);
+        assert(list.get_chunk_count() == 9);
+        std::vector<std::size_t> segment_sizes;
+        for (std::span<int> segment : list.segments())
+            segment_sizes.push_back(segment.size());
+        assert((segment_sizes == std::vector<std::size_t>{4, 8, 16, 32, 32, 32, 32, 32, 12}));
+        for (int i = 0; i < 200; i++)
+            assert(list[i] == i);
+        assert(*(list.begin() + 27) == 27 && *(list.begin() + 28) == 28);
+
+        list.reserve(400);
+        assert(list.capacity() >= 400);
+        std::size_t misses = list.get_chunk_pool().GetMisses();
+        for (int i = 200; i < 400; i++)
+            list.push_back(i);
+        assert(list.get_chunk_pool().GetMisses() == misses);
+
+        ChunkList<int, dynamic_chunk_size> growing(ChunkSizing::Geometric(4, 32));
+        growing.reserve(12);
+        assert(growing.capacity() == 12);
+        growing.reserve(60);
+        assert(growing.capacity() == 60);
+        misses = growing.get_chunk_pool().GetMisses();
+        for (int i = 0; i < 60; i++)
+            growing.push_back(i);
+        assert(growing.get_chunk_pool().GetMisses() == misses && growing.get_chunk_count() == 4);
+
+        std::deque<int> expected(list.begin(), list.end());
+        for (int step = 0; step < 300; step++) {
+            int index = (step * 37) % static_cast<int>(expected.size());
+            if (step % 3 == 0) {
+                list.insert(list.cbegin() + index, -step);
+                expected.insert(expected.begin() + index, -step);
+            }
+            else if (step % 3 == 1) {
+                list.erase(list.cbegin() + index);
+                expected.erase(expected.begin() + index);
+            }
+            else {
+                list.push_front(step);
+                expected.push_front(step);
+            }
+        }
+        assert(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+        list.shrink_to_fit();
+        for (int i = 0; i < static_cast<int>(expected.size()); i++)
+            assert(list[i] == expected[i]);
+
+        ChunkList<int, dynamic_chunk_size> copy = list;
+        assert(copy == list && copy.get_chunk_sizing().GetLimit() == 32);
+
+        bool thrown = false;
+        try {
+            ChunkSizing::Geometric(3, 32);
+        }
+        catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    {
+        std::vector<int> values(5000);
+        for (int i = 0; i < 5000; i++)
+            values[i] = (i * 7919) % 1000 - 500;
+        ChunkList<int, 100> list(values.begin(), values.end());
+        assert(fefu_laboratory_two::sum(list) == std::accumulate(values.begin(), values.end(), 0LL));
+        assert(fefu_laboratory_two::min(list) == *std::min_element(values.begin(), values.end()));
+        assert(fefu_laboratory_two::max(list) == *std::max_element(values.begin(), values.end()));
+        assert(fefu_laboratory_two::count(list, 17) == std::count(values.begin(), values.end(), 17));
+        std::ptrdiff_t position = std::find(values.begin(), values.end(), 499) - values.begin();
+        assert(fefu_laboratory_two::find(list, 499) - list.begin() == position);
+        assert(fefu_laboratory_two::find(list, 1000) == list.end());
+
+        ChunkList<int, 64> other(values.begin(), values.end());
+        other.pop_front();
+        other.push_front(values[0]);
+        assert(fefu_laboratory_two::equal(list, other));
+        ChunkList<int, 100> same(values.begin(), values.end());
+        assert(list == same);
+        same[4321] = 12345;
+        assert(list != same);
+
+        std::vector<float> samples(1000);
+        for (int i = 0; i < 1000; i++)
+            samples[i] = static_cast<float>(i % 17) * 0.5f;
+        ChunkList<float, 128> series(samples.begin(), samples.end());
+        assert(fefu_laboratory_two::max(series) == 8.0f && fefu_laboratory_two::min(series) == 0.0f);
+        assert(fefu_laboratory_two::count(series, 2.5f) == std::count(samples.begin(), samples.end(), 2.5f));
+        assert(fefu_laboratory_two::sum(series) == std::accumulate(samples.begin(), samples.end(), 0.0f));
+
+        std::vector<std::int8_t> bytes(777, 3);
+        bytes[700] = -9;
+        assert(simd::Find(bytes.data(), bytes.size(), std::int8_t(-9)) == 700);
+        assert(simd::kernels::Find<std::int8_t>::Run(bytes.data(), bytes.size(), std::int8_t(-9)) == 700);
+        assert(simd::Sum(bytes.data(), bytes.size()) == 776 * 3 - 9);
+        assert((simd::kernels::Extremum<std::int8_t, false>::Run(bytes.data(), bytes.size()) == -9));
+        assert(simd::Equal(bytes.data(), 699, bytes.data() + 1));
+        assert(!simd::Equal(bytes.data(), 700, bytes.data() + 1));
+
+        ChunkList<std::string, 3> strings{"b", "c", "a"};
+        assert(fefu_laboratory_two::min(strings) == "a" && fefu_laboratory_two::max(strings) == "c");
+    }
+    {
+        ThreadPool pool(4);
+        assert(pool.GetThreadCount() == 4);
+
+        ChunkList<long long, 64> list;
+        for (int i = 0; i < 10000; i++)
+            list.push_back(i);
+
+        parallel::for_each(list, [](long long& value) { value *= 2; }, pool);
+        assert(list[0] == 0 && list[9999] == 19998);
+
+        assert(parallel::reduce(list, 0LL, pool) == 9999LL * 10000);
+        assert(parallel::reduce(list, 1LL, [](long long a, long long b) { return std::max(a, b); }, pool) == 19998);
+        assert(parallel::count_if(list, [](long long value) { return value % 3 == 0; }, pool) == 3334);
+
+        std::vector<long long> halves(list.get_size());
+        parallel::transform(list, halves.begin(), [](long long value) { return value / 2; }, pool);
+        for (int i = 0; i < 10000; i++)
+            assert(halves[i] == i);
+
+        ChunkList<long long, 100> negated(10000, 0LL);
+        parallel::transform(list, negated.begin(), [](long long value) { return -value; }, pool);
+        assert(negated[1234] == -2468 && negated.back() == -19998);
+
+        ChunkList<std::string, 16> words;
+        for (int i = 0; i < 200; i++)
+            words.push_back(std::to_string(i % 10));
+        assert(parallel::reduce(words, std::string(), pool).size() == 200);
+        assert(parallel::reduce(words, std::string(), pool).substr(0, 12) == "012345678901");
+        ChunkList<std::string, 16> letters;
+        std::string alphabet;
+        for (int i = 0; i < 500; i++) {
+            letters.push_back(std::string(1, static_cast<char>('a' + i * 7 % 26)));
+            alphabet += letters.back();
+        }
+        auto concatenate = [](std::string left, const std::string& right) { return std::move(left) + right; };
+        assert(parallel::reduce(letters, std::string(">"), concatenate, pool) == ">" + alphabet);
+
+        std::atomic<int> nested = 0;
+        pool.ParallelFor(8, [&](std::size_t) {
+            pool.ParallelFor(8, [&](std::size_t) { nested++; });
+        });
+        assert(nested == 64);
+
+        bool thrown = false;
+        try {
+            parallel::for_each(list, [](long long& value) {
+                if (value == 5000) {
+                    throw std::runtime_error("failed");
+                }
+            }, pool);
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        ThreadPool single(1);
+        ChunkList<int, 8> empty_list;
+        assert(parallel::reduce(empty_list, 7, single) == 7);
+        assert(parallel::count_if(empty_list, [](int) { return true; }, pool) == 0);
+    }
+    {
+        ChunkList<long long, 64> list;
+        list.push_back(-1);
+        list.push_front(-2);
+        {
+            ConcurrentAppender appender(list);
+            std::atomic<bool> done = false;
+            std::size_t last_published = 0;
+            std::thread reader([&] {
+                while (!done.load()) {
+                    std::size_t published = appender.GetPublishedSize();
+                    assert(published >= last_published);
+                    long long previous_first = -3;
+                    std::size_t visited = appender.ForEachPublished([&](long long value) {
+                        if (value >= 0 && (value >> 20) == 0) {
+                            assert(value > previous_first);
+                            previous_first = value;
+                        }
+                    });
+                    assert(visited >= published);
+                    last_published = published;
+                }
+            });
+            std::vector<std::thread> producers;
+            for (long long thread = 0; thread < 4; thread++) {
+                producers.emplace_back([&appender, thread] {
+                    for (long long i = 0; i < 5000; i++)
+                        appender.push_back((thread << 20) | i);
+                });
+            }
+            for (std::thread& producer : producers)
+                producer.join();
+            done = true;
+            reader.join();
+            appender.Quiesce();
+            assert(appender.GetPublishedSize() == 20002);
+        }
+        assert(list.get_size() == 20002);
+        assert(list[0] == -2 && list[1] == -1);
+        std::vector<long long> next_expected(4, 0);
+        for (int i = 2; i < list.get_size(); i++) {
+            long long value = list[i];
+            assert((value & 0xFFFFF) == next_expected[value >> 20]);
+            next_expected[value >> 20]++;
+        }
+        assert(std::count(next_expected.begin(), next_expected.end(), 5000) == 4);
+        list.push_back(7);
+        list.pop_front();
+        assert(list.back() == 7 && list.front() == -1 && list.get_size() == 20002);
+
+        ChunkList<std::string, 4> words;
+        {
+            ConcurrentAppender appender(words);
+            std::thread first([&] { for (int i = 0; i < 100; i++) appender.emplace_back("a"); });
+            std::thread second([&] { for (int i = 0; i < 100; i++) appender.emplace_back(3, 'b'); });
+            first.join();
+            second.join();
+        }
+        assert(words.get_size() == 200);
+        assert(fefu_laboratory_two::count(words, std::string("bbb")) == 100);
+    }
+    {
+        ChunkQueue<int, 4> queue(10);
+        assert(queue.capacity() == 16);
+        for (int i = 0; i < 16; i++)
+            assert(queue.try_push(i));
+        assert(!queue.try_push(16));
+        assert(queue.size_approx() == 16);
+        for (int lap = 0; lap < 3; lap++) {
+            for (int i = 0; i < 10; i++)
+                assert(*queue.try_pop() == lap * 10 + i);
+            for (int i = 0; i < 10; i++)
+                assert(queue.try_push(16 + lap * 10 + i));
+        }
+        for (int i = 30; i < 46; i++)
+            assert(queue.pop() == i);
+        assert(!queue.try_pop());
+
+        ChunkQueue<std::unique_ptr<std::string>, 8> owners(8);
+        owners.push(std::make_unique<std::string>("left"));
+        owners.push(std::make_unique<std::string>("behind"));
+        assert(*owners.pop() == "left");
+
+        struct Fragile {
+            int value;
+            const bool* armed;
+
+            Fragile(int value, const bool* armed) : value(value), armed(armed) {}
+
+            Fragile(Fragile&& other) : value(other.value), armed(other.armed) {
+                if (*armed) {
+                    throw std::runtime_error("move");
+                }
+            }
+        };
+        bool armed = false;
+        ChunkQueue<Fragile, 2> fragile(4);
+        for (int i = 0; i < 4; i++)
+            assert(fragile.try_emplace(i, &armed));
+        armed = true;
+        bool failed = false;
+        try {
+            fragile.try_pop();
+        }
+        catch (const std::runtime_error&) {
+            failed = true;
+        }
+        armed = false;
+        assert(failed && fragile.try_pop()->value == 1);
+        for (int i = 4; i < 6; i++)
+            assert(fragile.try_emplace(i, &armed));
+        for (int i = 2; i < 6; i++)
+            assert(fragile.pop().value == i);
+        assert(!fragile.try_pop());
+
+        ChunkQueue<long long, 64> shared(256);
+        std::atomic<long long> total = 0;
+        std::vector<std::thread> threads;
+        for (int producer = 0; producer < 3; producer++) {
+            threads.emplace_back([&shared, producer] {
+                for (long long i = 1; i <= 20000; i++)
+                    shared.push(i * 3 + producer);
+            });
+        }
+        for (int consumer = 0; consumer < 3; consumer++) {
+            threads.emplace_back([&shared, &total] {
+                long long sum = 0;
+                for (int i = 0; i < 20000; i++)
+                    sum += shared.pop();
+                total += sum;
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        assert(total == 3 * 3 * (20000LL * 20001 / 2) + 3 * 20000);
+        assert(!shared.try_pop());
+    }
+    {
+        ChunkList<int, 4> list;
+        for (int i = 0; i < 10; i++)
+            list.push_back(i);
+        const ChunkList<int, 4>& original = list;
+        ChunkList<int, 4> snapshot = list;
+        assert(&std::as_const(snapshot)[5] == &original[5]);
+        assert(snapshot == list && snapshot.get_chunk_count() == 3);
+
+        list[5] = 50;
+        list.pop_front();
+        assert(std::as_const(snapshot)[5] == 5 && snapshot.get_size() == 10 && snapshot.front() == 0);
+        assert(&std::as_const(snapshot)[0] != &original[0] && &std::as_const(snapshot)[9] == &original[8]);
+
+        snapshot.erase(snapshot.begin() + 1);
+        assert(list[0] == 1 && snapshot[1] == 2 && snapshot.get_size() == 9);
+        assert(&std::as_const(snapshot)[8] == &original[8]);
+
+        ChunkList<int, 4> copy = list;
+        ChunkList<int, 4> nested = copy;
+        const int* shared = &std::as_const(nested)[8];
+        list.clear();
+        copy.clear();
+        snapshot.clear();
+        nested[8] = 90;
+        assert(&std::as_const(nested)[8] == shared && nested[4] == 50);
+
+        ChunkList<std::string, 2> words;
+        for (int i = 0; i < 7; i++)
+            words.push_back(std::string(20, 'a' + i));
+        ChunkList<std::string, 2> later;
+        later = words;
+        words.insert(words.begin() + 3, "x");
+        words.pop_back();
+        later.emplace_front("y");
+        assert(words.get_size() == 7 && words[3] == "x" && words[6] == std::string(20, 'f'));
+        assert(later.get_size() == 8 && later[0] == "y" && later[7] == std::string(20, 'g'));
+        for (std::string& word : later)
+            word += "!";
+        assert(words[0] == std::string(20, 'a') && later[1] == std::string(20, 'a') + "!");
+    }
+    {
+        ChunkList<int, 4> list;
+        for (int i = 0; i < 1000; i++)
+            list.push_back(i * 7);
+        list.push_front(-1);
+        std::FILE* file = std::tmpfile();
+        int fd = fileno(file);
+        write_binary(fd, list, true);
+        write_binary(fd, ChunkList<int, 4>());
+        lseek(fd, 0, SEEK_SET);
+
+        ChunkList<int, 3> read{5, 6};
+        read_binary(fd, read);
+        assert(read.get_size() == 1001 && read.front() == -1 && read[1000] == 999 * 7);
+        assert(std::equal(read.begin(), read.end(), list.begin()));
+        read_binary(fd, read);
+        assert(read.empty());
+        bool failed = false;
+        try {
+            read_binary(fd, read);
+        }
+        catch (const std::runtime_error&) {
+            failed = true;
+        }
+        assert(failed);
+
+        lseek(fd, sizeof(BinaryHeader) + 40, SEEK_SET);
+        int corrupt = 12345;
+        assert(write(fd, &corrupt, sizeof(corrupt)) == sizeof(corrupt));
+        lseek(fd, 0, SEEK_SET);
+        failed = false;
+        try {
+            read_binary(fd, read);
+        }
+        catch (const std::runtime_error& error) {
+            failed = std::string(error.what()) == "checksum mismatch";
+        }
+        assert(failed && read.empty());
+
+        lseek(fd, 0, SEEK_SET);
+        ChunkList<long long, 4> wide;
+        failed = false;
+        try {
+            read_binary(fd, wide);
+        }
+        catch (const std::runtime_error& error) {
+            failed = std::string(error.what()) == "element size mismatch";
+        }
+        assert(failed);
+        std::fclose(file);
+    }
+    {
+        std::string path = "/tmp/chunklist_mapped_" + std::to_string(getpid());
+        std::byte* base;
+        {
+            MappedChunkList<long long, 256> mapped(path, 1 << 26);
+            for (int i = 0; i < 10000; i++)
+                mapped->push_back(i);
+            mapped->erase(mapped->begin() + 100, mapped->begin() + 300);
+            base = mapped.get_file().GetBase();
+        }
+        {
+            MappedChunkList<long long, 256> mapped(path, 1 << 26);
+            assert(mapped.get_file().GetBase() == base);
+            assert(mapped->get_size() == 9800 && (*mapped)[100] == 300 && mapped->back() == 9999);
+            mapped->push_back(10000);
+            bool failed = false;
+            try {
+                MappedChunkList<long long, 256> again(path, 1 << 26);
+            }
+            catch (const std::system_error&) {
+                failed = true;
+            }
+            assert(failed);
+        }
+        void* blocker = mmap(base, 4096, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+        {
+            MappedChunkList<long long, 256> mapped(path, 1 << 26);
+            assert(mapped.get_file().GetBase() != base);
+            assert(mapped->get_size() == 9801 && (*mapped)[9800] == 10000);
+            mapped.advise(Advice::Sequential);
+            assert(fefu_laboratory_two::sum(std::as_const(*mapped)) == 49995000 - 39900 + 10000);
+        }
+        munmap(blocker, 4096);
+        bool failed = false;
+        try {
+            MappedChunkList<int, 256> wrong(path, 1 << 26);
+        }
+        catch (const std::runtime_error&) {
+            failed = true;
+        }
+        assert(failed);
+
+        std::uint64_t oversized = std::uint64_t(1) << 31;
+        std::FILE* image = std::fopen(path.c_str(), "r+b");
+        std::fseek(image, offsetof(MappedFile::Superblock, size), SEEK_SET);
+        std::fwrite(&oversized, sizeof(oversized), 1, image);
+        std::fclose(image);
+        failed = false;
+        try {
+            MappedChunkList<long long, 256> mapped(path, 1 << 26);
+        }
+        catch (const std::length_error&) {
+            failed = true;
+        }
+        assert(failed);
+        std::remove(path.c_str());
+    }
+    {
+        ChunkList<int, 8> list;
+        std::deque<int> expected;
+        std::mt19937 random(21);
+        for (int step = 0; step < 4000; step++) {
+            int size = static_cast<int>(expected.size());
+            int index = size == 0 ? 0 : static_cast<int>(random() % (size + 1));
+            switch (random() % 7) {
+                case 0:
+                case 1:
+                    list.insert(list.cbegin() + index, step);
+                    expected.insert(expected.begin() + index, step);
+                    break;
+                case 2:
+                    if (index < size) {
+                        int last = std::min(size, index + static_cast<int>(random() % 20));
+                        list.erase(list.cbegin() + index, list.cbegin() + last);
+                        expected.erase(expected.begin() + index, expected.begin() + last);
+                    }
+                    break;
+                case 3: {
+                    std::vector<int> values(random() % 30, -step);
+                    list.insert(list.cbegin() + index, values.begin(), values.end());
+                    expected.insert(expected.begin() + index, values.begin(), values.end());
+                    break;
+                }
+                case 4:
+                    list.push_back(step);
+                    expected.push_back(step);
+                    break;
+                case 5:
+                    list.push_front(step);
+                    expected.push_front(step);
+                    break;
+                default:
+                    if (size > 1) {
+                        list.pop_front();
+                        expected.pop_front();
+                        list.pop_back();
+                        expected.pop_back();
+                    }
+                    break;
+            }
+            assert(list.get_size() == static_cast<int>(expected.size()));
+            for (int probe = 0; probe < 3 && !expected.empty(); probe++) {
+                int position = static_cast<int>(random() % expected.size());
+                assert(std::as_const(list)[position] == expected[position]);
+            }
+        }
+        assert(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+    }
+    {
+        std::mt19937 random(22);
+        ChunkList<int, 16> list;
+        std::vector<int> expected;
+        for (int i = 0; i < 1000; i++) {
+            int value = static_cast<int>(random() % 500);
+            if (i % 3 == 0) {
+                list.push_front(value);
+                expected.insert(expected.begin(), value);
+            }
+            else {
+                list.push_back(value);
+                expected.push_back(value);
+            }
+        }
+        list.erase(list.cbegin() + 100, list.cbegin() + 110);
+        expected.erase(expected.begin() + 100, expected.begin() + 110);
+        ChunkList<int, 16> snapshot(list);
+        fefu_laboratory_two::sort(list);
+        std::sort(expected.begin(), expected.end());
+        assert(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+        assert(std::as_const(list)[500] == expected[500]);
+        assert(!std::is_sorted(snapshot.begin(), snapshot.end()) && snapshot.get_size() == 990);
+        fefu_laboratory_two::sort(snapshot, std::greater<>());
+        assert(std::equal(snapshot.begin(), snapshot.end(), expected.rbegin(), expected.rend()));
+
+        ChunkList<std::pair<int, int>, 8> pairs;
+        for (int i = 0; i < 300; i++) {
+            pairs.emplace_back(static_cast<int>(random() % 10), i);
+        }
+        auto by_key = [](const auto& first, const auto& second) { return first.first < second.first; };
+        fefu_laboratory_two::stable_sort(pairs, by_key);
+        assert(std::is_sorted(pairs.begin(), pairs.end()));
+
+        ChunkList<int, 16> partial;
+        for (int i = 0; i < 500; i++) {
+            partial.push_back(static_cast<int>(random() % 1000));
+        }
+        std::vector<int> values(partial.begin(), partial.end());
+        fefu_laboratory_two::partial_sort(partial, 40);
+        std::partial_sort(values.begin(), values.begin() + 40, values.end());
+        assert(std::equal(values.begin(), values.begin() + 40, partial.begin()));
+        assert(partial.get_size() == 500);
+        std::vector<int> rest(partial.begin(), partial.end());
+        std::sort(rest.begin(), rest.end());
+        std::sort(values.begin(), values.end());
+        assert(rest == values);
+
+        ThreadPool pool(4);
+        ChunkList<int, 16> shuffled;
+        for (int i = 0; i < 5000; i++) {
+            shuffled.push_back(static_cast<int>(random() % 100000));
+        }
+        fefu_laboratory_two::parallel::sort(shuffled, std::less<>(), pool);
+        assert(std::is_sorted(shuffled.begin(), shuffled.end()) && shuffled.get_size() == 5000);
+        ChunkList<std::pair<int, int>, 8> stable;
+        for (int i = 0; i < 300; i++) {
+            stable.emplace_back(static_cast<int>(random() % 10), i);
+        }
+        fefu_laboratory_two::parallel::stable_sort(stable, by_key, pool);
+        assert(std::is_sorted(stable.begin(), stable.end()));
+
+        ChunkList<std::unique_ptr<int>, 4> owners;
+        for (int i = 0; i < 50; i++) {
+            owners.push_back(std::make_unique<int>((i * 37) % 50));
+        }
+        fefu_laboratory_two::sort(owners, [](const auto& first, const auto& second) { return *first < *second; });
+        for (int i = 0; i < 50; i++) {
+            assert(*std::as_const(owners)[i] == i);
+        }
+
+        int comparisons = 0;
+        ChunkList<int, 16> counted(partial);
+        fefu_laboratory_two::sort(counted, [&](int first, int second) {
+            comparisons++;
+            return first > second;
+        });
+        int limit = comparisons - 50;
+        comparisons = 0;
+        bool failed = false;
+        try {
+            fefu_laboratory_two::sort(partial, [&](int first, int second) {
+                if (++comparisons == limit) {
+                    throw std::runtime_error("compare");
+                }
+                return first > second;
+            });
+        }
+        catch (const std::runtime_error&) {
+            failed = true;
+        }
+        assert(failed && partial.get_size() == 500);
+        rest.assign(partial.begin(), partial.end());
+        std::sort(rest.begin(), rest.end());
+        assert(rest == values);
+    }
+    {
+        ColumnarChunkList<int, double, std::string> table;
+        static_assert(std::random_access_iterator<decltype(table.begin())>);
+        for (int i = 0; i < 3000; i++) {
+            table.emplace_back(i, i * 0.5, std::to_string(i));
+        }
+        assert(table.get_size() == 3000 && table.get_chunk_count() == 3);
+        auto [id, price, name] = table[1234];
+        assert(id == 1234 && price == 617.0 && name == "1234");
+        price = -1.0;
+        assert(table.at(1234).get<1>() == -1.0);
+        table[10] = std::make_tuple(7, 3.5, std::string("seven"));
+        assert(table[10] == std::make_tuple(7, 3.5, std::string("seven")));
+        table[11] = std::as_const(table)[10];
+        assert(std::get<2>(std::tuple<int, double, std::string>(table[11])) == "seven");
+
+        auto ids = std::as_const(table).column<0>();
+        assert(ids.get_size() == 3000 && ids[2999] == 2999);
+        assert(fefu_laboratory_two::sum(ids) == 2999LL * 3000 / 2 - 10 - 11 + 14);
+        assert(fefu_laboratory_two::count(ids, 7) == 3);
+        assert(*fefu_laboratory_two::find(ids, 2048) == 2048);
+        for (auto segment : table.column<1>().segments()) {
+            assert(reinterpret_cast<std::uintptr_t>(segment.data()) % 64 == 0);
+        }
+        auto prices = table.column<1>();
+        fefu_laboratory_two::fill(prices, 2.0);
+        assert(fefu_laboratory_two::sum(std::as_const(table).column<1>()) == 6000.0);
+        auto found = std::find(table.column<0>().begin(), table.column<0>().end(), 2500);
+        auto names = std::as_const(table).column<2>().begin() + 2500;
+        assert(found - table.column<0>().begin() == 2500 && *found == 2500 && *names == "2500");
+        *found = -2500;
+        assert(table[2500].get<0>() == -2500);
+        *found = 2500;
+
+        ColumnarChunkList<int, double, std::string> copy(table);
+        for (int i = 0; i < 1000; i++) {
+            table.pop_back();
+        }
+        assert(table.get_size() == 2000 && table.get_chunk_count() == 2);
+        std::size_t rows = 0;
+        for (auto segment : std::as_const(table).column<2>().segments()) {
+            assert(segment.front() == std::to_string(rows));
+            rows += segment.size();
+        }
+        assert(rows == 2000);
+        assert(copy.get_size() == 3000 && copy.back().get<2>() == "2999");
+        assert(std::equal(table.begin(), table.end(), copy.begin()));
+        ColumnarChunkList<int, double, std::string> moved(std::move(copy));
+        assert(copy.empty() && moved.get_size() == 3000);
+        moved.clear();
+        assert(moved.empty() && moved.get_chunk_count() == 0);
+        bool failed = false;
+        try {
+            moved.front();
+        }
+        catch (const std::out_of_range&) {
+            failed = true;
+        }
+        assert(failed);
+    }
+    {
+        struct CountingResource : std::pmr::memory_resource {
+            std::size_t allocations = 0;
+            std::size_t deallocations = 0;
+
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                allocations++;
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+                deallocations++;
+                std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+
+        using Bucket = ChunkList<int, 8, std::pmr::polymorphic_allocator<int>, true, true>;
+        CountingResource resource;
+        {
+            Bucket bucket(&resource);
+            for (int i = 0; i < 8; i++) {
+                bucket.push_back(i);
+            }
+            bucket.pop_front();
+            bucket.push_front(-1);
+            assert(bucket.capacity() == 8 && bucket[7] == 7);
+            Bucket copy(bucket);
+            copy[0] = 100;
+            assert(bucket[0] == -1 && copy[0] == 100);
+            assert(resource.allocations == 0);
+            bucket.push_back(8);
+            assert(resource.allocations > 0 && bucket[8] == 8);
+        }
+        assert(resource.allocations == resource.deallocations);
+
+        using Strings = ChunkList<std::string, 4, Allocator<std::string>, true, true>;
+        Strings first;
+        Strings second;
+        for (int i = 0; i < 10; i++) {
+            first.push_back("first " + std::to_string(i));
+        }
+        second.push_back("second");
+        first.pop_front();
+        second.swap(first);
+        assert(first.get_size() == 1 && first[0] == "second");
+        assert(second.get_size() == 9 && second[0] == "first 1" && second[8] == "first 9");
+        first = std::move(second);
+        assert(first.get_size() == 9 && second.empty() && first.back() == "first 9");
+        {
+            Strings snapshot(first);
+            first.clear();
+            first.push_back("again");
+            assert(snapshot.get_size() == 9 && snapshot.front() == "first 1");
+            first = snapshot;
+        }
+        Strings moved(std::move(first));
+        moved.push_front("front");
+        assert(moved.get_size() == 10 && moved[0] == "front" && moved[1] == "first 1");
+        std::vector<std::string> expected(moved.begin(), moved.end());
+        std::sort(expected.begin(), expected.end());
+        fefu_laboratory_two::sort(moved);
+        assert(std::equal(moved.begin(), moved.end(), expected.begin(), expected.end()));
+        assert(moved[9] == "front");
+    }
+    {
+        ChunkList<std::string, 8> list;
+        for (int i = 0; i < 200; i++) {
+            list.push_back(std::to_string(i));
+        }
+        ChunkList<std::string, 8> snapshot(list);
+        auto next = list.erase(list.cbegin() + 13, list.cbegin() + 171);
+        assert(list.get_size() == 42 && *next == "171");
+        for (int i = 0; i < 42; i++) {
+            assert(list[i] == std::to_string(i < 13 ? i : i + 158));
+        }
+        list.erase(list.cbegin() + 8, list.cbegin() + 40);
+        assert(list.get_size() == 10 && list[7] == "7" && list[8] == "198" && list.back() == "199");
+        list.erase(list.cbegin(), list.cend());
+        assert(list.empty() && list.begin() == list.end());
+        list.push_back("again");
+        assert(list.front() == "again" && list.get_size() == 1);
+        assert(snapshot.get_size() == 200 && snapshot[100] == "100" && snapshot.back() == "199");
+    }
+
+    {
+        ChunkList<int, 4> list;
+        for (int i = 0; i < 40; i++)
+            list.push_back(i);
+        const ChunkList<int, 4>& original = list;
+        ChunkList<int, 4> snapshot = list;
+        auto shared_chunks = [&] {
+            int shared = 0;
+            for (int i = 0; i < 40; i += 4)
+                shared += &std::as_const(snapshot)[i] == &original[i];
+            return shared;
+        };
+        assert(fefu_laboratory_two::count(snapshot, 17) == 1 && fefu_laboratory_two::sum(snapshot) == 780);
+        int total = 0;
+        for (int value : std::as_const(snapshot))
+            total += value;
+        assert(total == 780 && shared_chunks() == 10);
+
+        auto found = fefu_laboratory_two::find(snapshot, 17);
+        assert(*found == 17 && found - snapshot.begin() == 17 && shared_chunks() == 8);
+        *found = 170;
+        assert(snapshot[17] == 170 && original[17] == 17);
+        assert(snapshot.nth(22)[-3] == 19 && shared_chunks() == 7);
+
+        auto segments = snapshot.segments();
+        auto segment = segments.begin();
+        ++segment;
+        (*segment)[0] = 40;
+        assert(snapshot[4] == 40 && original[4] == 4 && shared_chunks() == 6);
+
+        std::mt19937 random(23);
+        std::vector<int> expected(original.begin(), original.end());
+        ChunkList<int, 4> copy = list;
+        auto position = copy.begin();
+        for (int step = 0; step < 200; step++) {
+            std::ptrdiff_t at = position - copy.begin();
+            std::ptrdiff_t target = static_cast<std::ptrdiff_t>(random() % 40);
+            switch (random() % 3) {
+                case 0:
+                    position += target - at;
+                    break;
+                case 1:
+                    position = target > at ? std::next(position, target - at) : std::prev(position, at - target);
+                    break;
+                default:
+                    position = copy.nth(target);
+                    break;
+            }
+            *position = step;
+            expected[target] = step;
+        }
+        assert(std::equal(copy.begin(), copy.end(), expected.begin(), expected.end()));
+        for (int i = 0; i < 40; i++)
+            assert(original[i] == i);
+    }
     std::cout << "All tests passed." << std::endl;
 
     return 0;
@@ -1,7 +1,21 @@
 #pragma once
+#include "SegmentedAlgorithms.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <iostream>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
 
 namespace fefu_laboratory_two {
     template <typename T>
@@ -21,7 +35,14 @@ namespace fefu_laboratory_two {
         ~Allocator() = default;
 
         pointer allocate(size_type n) {
-            auto p = static_cast<pointer>(malloc(sizeof(value_type) * n));
+            pointer p;
+            if constexpr (alignof(value_type) > alignof(std::max_align_t)) {
+                size_type bytes = (sizeof(value_type) * n + alignof(value_type) - 1) / alignof(value_type) * alignof(value_type);
+                p = static_cast<pointer>(std::aligned_alloc(alignof(value_type), bytes));
+            }
+            else {
+                p = static_cast<pointer>(malloc(sizeof(value_type) * n));
+            }
             if (p)
                 return p;
 
@@ -32,6 +53,11 @@ namespace fefu_laboratory_two {
             (void)n;
             free(p);
         }
+
+        template <class U>
+        friend bool operator==(const Allocator<T>&, const Allocator<U>&) noexcept {
+            return true;
+        }
     };
 
     template <typename ValueType>
@@ -45,9 +71,26 @@ namespace fefu_laboratory_two {
         virtual reference operator[](std::ptrdiff_t position) = 0;
     };
 
+    template <typename ValueType>
+    class Chunk;
+
+    // Lets a non-const iterator over a list that may share chunks with a copy
+    // ask the list for its own copy of the chunk it steps onto, given the
+    // index of that chunk's first element. Empty when nothing is shared.
+    template <typename ValueType>
+    struct ChunkUnsharer {
+        void* list = nullptr;
+        Chunk<ValueType>* (*own)(void*, Chunk<ValueType>*, std::ptrdiff_t) = nullptr;
+
+        Chunk<ValueType>* operator()(Chunk<ValueType>* chunk, std::ptrdiff_t first_index) const {
+            return list == nullptr ? chunk : own(list, chunk, first_index);
+        }
+    };
+
     template <typename ValueType>
     class ChunkList_iterator {
     public:
+        using iterator_category = std::random_access_iterator_tag;
         using value_type = ValueType;
         using difference_type = std::ptrdiff_t;
         using pointer = ValueType*;
@@ -56,14 +99,86 @@ namespace fefu_laboratory_two {
 
     protected:
         pointer value = nullptr;
-        IChunkList<value_type>* chunk = nullptr;
-        int index = 0;
+        pointer first = nullptr;
+        pointer last = nullptr;
+        Chunk<value_type>* chunk = nullptr;
+        difference_type index = 0;
+        ChunkUnsharer<value_type> unsharer;
+
+        void SetChunk(Chunk<value_type>* new_chunk) noexcept {
+            chunk = new_chunk;
+            first = chunk->data();
+            last = first + chunk->current_size;
+        }
+
+        void Own() {
+            if (unsharer.list != nullptr && chunk != nullptr) {
+                difference_type offset = value - first;
+                Chunk<value_type>* unique = unsharer(chunk, index - offset);
+                if (unique != chunk) {
+                    SetChunk(unique);
+                    value = first + offset;
+                }
+            }
+        }
+
+        void Increment() {
+            ++index;
+            if (++value == last && chunk->next != nullptr) {
+                SetChunk(chunk->next);
+                value = first;
+                Own();
+            }
+        }
+
+        void Decrement() {
+            --index;
+            if (value == first) {
+                SetChunk(chunk->prev);
+                value = last - 1;
+                Own();
+                return;
+            }
+            --value;
+        }
+
+        void Advance(difference_type difference) {
+            Chunk<value_type>* entered = chunk;
+            index += difference;
+            if (difference >= 0) {
+                while (chunk != nullptr && difference >= last - value && chunk->next != nullptr) {
+                    difference -= last - value;
+                    SetChunk(chunk->next);
+                    value = first;
+                }
+                value += difference;
+            }
+            else {
+                difference = -difference;
+                while (difference > value - first) {
+                    difference -= value - first;
+                    SetChunk(chunk->prev);
+                    value = last;
+                }
+                value -= difference;
+            }
+            if (chunk != entered) {
+                Own();
+            }
+        }
 
     public:
         ChunkList_iterator() noexcept = default;
 
-        ChunkList_iterator(pointer current_value, size_type current_index, IChunkList<value_type>* current_chunk) :
-                value(current_value), index(current_index), chunk(current_chunk) {}
+        ChunkList_iterator(Chunk<value_type>* current_chunk, pointer current_value, difference_type current_index,
+                           ChunkUnsharer<value_type> chunk_unsharer = {}) :
+                value(current_value), chunk(current_chunk), index(current_index), unsharer(chunk_unsharer) {
+            if (chunk != nullptr) {
+                first = chunk->data();
+                last = first + chunk->current_size;
+            }
+            Own();
+        }
 
         ChunkList_iterator(const ChunkList_iterator& other) noexcept = default;
 
@@ -71,14 +186,20 @@ namespace fefu_laboratory_two {
 
         ~ChunkList_iterator() = default;
 
-        int GetIndex() {
+        difference_type GetIndex() const noexcept {
             return index;
         }
 
+        pointer GetSegmentBegin() const noexcept {
+            return first;
+        }
+
+        pointer GetSegmentEnd() const noexcept {
+            return last;
+        }
+
         friend void swap(ChunkList_iterator<ValueType>& first, ChunkList_iterator<ValueType>& second) {
-            std::swap(first.chunk, second.chunk);
-            std::swap(first.value, second.value);
-            std::swap(first.index, second.index);
+            std::swap(first, second);
         }
 
         friend bool operator==(const ChunkList_iterator<ValueType>& first,
@@ -99,62 +220,60 @@ namespace fefu_laboratory_two {
         }
 
         ChunkList_iterator& operator++() {
-            if (index + 1 == chunk->GetSize()) {
-                this->chunk = nullptr;
-                this->value = nullptr;
-                this->index = 0;
-                return *this;
-            }
-            this->value = &chunk->at(++index);
+            Increment();
             return *this;
         }
 
         ChunkList_iterator operator++(int) {
-            if (index + 1 == chunk->GetSize()) {
-                return ChunkList_iterator();
-            }
-            this->value = &chunk->at(++index);
-            return *this;
+            ChunkList_iterator previous = *this;
+            Increment();
+            return previous;
         }
 
         ChunkList_iterator& operator--() {
-            if (index - 1 < 0) {
-                throw std::exception();
-            }
-            this->value = &chunk->at(--index);
+            Decrement();
             return *this;
         }
 
         ChunkList_iterator operator--(int) {
-            if (index - 1 < 0) {
-                throw std::exception();
-            }
-            this->value = &chunk->at(--index);
-            return *this;
+            ChunkList_iterator previous = *this;
+            Decrement();
+            return previous;
         }
 
         ChunkList_iterator operator+(const difference_type& difference) const {
-            return ChunkList_iterator(&chunk->at(index + difference), index + difference, chunk);
+            ChunkList_iterator result = *this;
+            result.Advance(difference);
+            return result;
+        }
+
+        friend ChunkList_iterator operator+(const difference_type& difference, const ChunkList_iterator& iterator) {
+            return iterator + difference;
         }
 
         ChunkList_iterator& operator+=(const difference_type& difference) {
-            this->index += difference;
-            this->value = &chunk->at(index);
+            Advance(difference);
             return *this;
         }
 
         ChunkList_iterator operator-(const difference_type& difference) const {
-            return ChunkList_iterator(&chunk->at(index - difference), index - difference, chunk);
+            ChunkList_iterator result = *this;
+            result.Advance(-difference);
+            return result;
         }
 
         ChunkList_iterator& operator-=(const difference_type& difference) {
-            this->index -= difference;
-            this->value = &chunk->at(index);
+            Advance(-difference);
             return *this;
         }
 
-        reference operator[](const difference_type& n) {
-            return chunk[n];
+        friend difference_type operator-(const ChunkList_iterator<ValueType>& first,
+                                         const ChunkList_iterator<ValueType>& second) {
+            return first.index - second.index;
+        }
+
+        reference operator[](const difference_type& n) const {
+            return *(*this + n);
         }
 
         friend bool operator<(const ChunkList_iterator<ValueType>& first,
@@ -180,6 +299,7 @@ namespace fefu_laboratory_two {
     template <typename ValueType>
     class ChunkList_const_iterator : public ChunkList_iterator<ValueType> {
     public:
+        using iterator_category = std::random_access_iterator_tag;
         using value_type = ValueType;
         using difference_type = std::ptrdiff_t;
         using pointer = const ValueType*;
@@ -187,13 +307,15 @@ namespace fefu_laboratory_two {
 
         ChunkList_const_iterator() : ChunkList_iterator<value_type>() {};
 
-        ChunkList_const_iterator(value_type* value, int index, IChunkList<value_type>* chunk) :
-                ChunkList_iterator<ValueType>(value, index, chunk) {};
+        ChunkList_const_iterator(Chunk<value_type>* chunk, value_type* value, difference_type index) :
+                ChunkList_iterator<ValueType>(chunk, value, index) {};
 
-        ChunkList_const_iterator(const ChunkList_const_iterator& other) noexcept = default;
+        ChunkList_const_iterator(const ChunkList_iterator<value_type>& other) noexcept :
+                ChunkList_iterator<value_type>(other) {
+            this->unsharer = {};
+        }
 
-        ChunkList_const_iterator(pointer value, int index, const IChunkList<value_type>* chunk) :
-                ChunkList_iterator<value_type>(const_cast<value_type*>(value), index, const_cast<IChunkList<value_type>*>(chunk)) {}
+        ChunkList_const_iterator(const ChunkList_const_iterator& other) noexcept = default;
 
         ChunkList_const_iterator& operator=(const ChunkList_const_iterator&) = default;
 
@@ -201,13 +323,7 @@ namespace fefu_laboratory_two {
 
         friend void swap(ChunkList_const_iterator<ValueType>& first,
                          ChunkList_const_iterator<ValueType>& second) {
-            std::swap(first.value, second.value);
-            std::swap(first.chunk, second.chunk);
-            std::swap(first.index, second.index);
-        }
-
-        int GetIndex() {
-            return this->index;
+            std::swap(first, second);
         }
 
         friend bool operator==(const ChunkList_const_iterator<ValueType>& first,
@@ -229,62 +345,61 @@ namespace fefu_laboratory_two {
         }
 
         ChunkList_const_iterator& operator++() {
-            if (this->index + 1 == this->chunk->GetSize()) {
-                this->chunk = nullptr;
-                this->value = nullptr;
-                this->index = 0;
-                return *this;
-            }
-            this->value = &this->chunk->at(++this->index);
+            this->Increment();
             return *this;
         }
 
         ChunkList_const_iterator operator++(int) {
-            if (this->index + 1 == this->chunk->GetSize()) {
-                return ChunkList_const_iterator();
-            }
-            this->value = &this->chunk->at(++this->index);
-            return *this;
+            ChunkList_const_iterator previous = *this;
+            this->Increment();
+            return previous;
         }
 
         ChunkList_const_iterator& operator--() {
-            if (this->index - 1 < 0) {
-                throw std::exception();
-            }
-            this->value = &this->chunk->at(--this->index);
+            this->Decrement();
             return *this;
         }
 
         ChunkList_const_iterator operator--(int) {
-            if (this->index - 1 < 0) {
-                throw std::exception();
-            }
-            this->value = &this->chunk->at(--this->index);
-            return *this;
+            ChunkList_const_iterator previous = *this;
+            this->Decrement();
+            return previous;
         }
 
         ChunkList_const_iterator operator+(const difference_type& difference) const {
-            return ChunkList_const_iterator(&this->chunk->at(this->index + difference), this->index + difference, this->chunk);
+            ChunkList_const_iterator result = *this;
+            result.Advance(difference);
+            return result;
+        }
+
+        friend ChunkList_const_iterator operator+(const difference_type& difference,
+                                                  const ChunkList_const_iterator& iterator) {
+            return iterator + difference;
         }
 
         ChunkList_const_iterator& operator+=(const difference_type& difference) {
-            this->index += difference;
-            this->value = &this->chunk->at(this->index);
+            this->Advance(difference);
             return *this;
         }
 
         ChunkList_const_iterator operator-(const difference_type& difference) const {
-            return ChunkList_const_iterator(&this->chunk->at(this->index - difference), this->index - difference, this->chunk);
+            ChunkList_const_iterator result = *this;
+            result.Advance(-difference);
+            return result;
         }
 
         ChunkList_const_iterator& operator-=(const difference_type& difference) {
-            this->index -= difference;
-            this->value = &this->chunk->at(this->index);
+            this->Advance(-difference);
             return *this;
         }
 
-        reference operator[](const difference_type& n) {
-            return this->chunk[n];
+        friend difference_type operator-(const ChunkList_const_iterator<ValueType>& first,
+                                         const ChunkList_const_iterator<ValueType>& second) {
+            return first.index - second.index;
+        }
+
+        reference operator[](const difference_type& n) const {
+            return *(*this + n);
         }
 
         friend bool operator<(const ChunkList_const_iterator<ValueType>& first,
@@ -309,552 +424,2234 @@ namespace fefu_laboratory_two {
     };
 
     template <typename ValueType>
-    class Chunk : IChunkList<ValueType> {
+    inline constexpr std::size_t chunk_alignment = alignof(ValueType) > 64 ? alignof(ValueType) : 64;
+
+    template <std::size_t Alignment>
+    struct alignas(Alignment) ChunkBlock {
+        std::byte bytes[Alignment];
+    };
+
+    template <typename ValueType>
+    class alignas(chunk_alignment<ValueType>) Chunk {
     public:
         using reference = ValueType&;
         using difference_type = std::ptrdiff_t;
         using pointer = ValueType*;
+        using const_pointer = const ValueType*;
         using size_type = std::size_t;
         using value_type = ValueType;
+        using block_type = ChunkBlock<chunk_alignment<ValueType>>;
 
         int size = 0;
         int current_size = 0;
-        pointer list = nullptr;
-        Allocator<value_type> allocator;
+        int begin_offset = 0;
+        int claimed = 0;
         Chunk* prev = nullptr;
         Chunk* next = nullptr;
+        // The block whose storage holds the elements. A chunk shared by
+        // several lists lives in one block, and every other list links a
+        // header-only view of it; references counts the holders.
+        Chunk* owner = this;
+        int references = 1;
 
-        Chunk(int chunk_size) : size(chunk_size)
-        {
-            list = allocator.allocate(size);
+        explicit Chunk(int chunk_size) noexcept : size(chunk_size) {}
+
+        Chunk(const Chunk& other) = delete;
+
+        Chunk& operator=(const Chunk& other) = delete;
+
+        ~Chunk() = default;
+
+        static constexpr size_type BlockCount(int chunk_size) noexcept {
+            return (sizeof(Chunk) + chunk_size * sizeof(value_type) + sizeof(block_type) - 1) / sizeof(block_type);
         }
 
-        Chunk(int chunk_size, Allocator<value_type> allocator) : size(chunk_size), allocator(allocator)
-        {
-            list = allocator.allocate(size);
+        pointer storage() noexcept {
+            return reinterpret_cast<pointer>(reinterpret_cast<std::byte*>(owner) + sizeof(Chunk));
         }
 
-        size_t GetSize() const noexcept override {
-            return current_size;
+        const_pointer storage() const noexcept {
+            return reinterpret_cast<const_pointer>(reinterpret_cast<const std::byte*>(owner) + sizeof(Chunk));
         }
 
-        reference at(size_type position) override {
-            if (position >= size || position < 0) {
-                throw std::out_of_range("out of range");
-            }
-            return list[position];
+        pointer data() noexcept {
+            return storage() + begin_offset;
         }
 
-        reference operator[](difference_type position) override {
-            return list[position];
+        const_pointer data() const noexcept {
+            return storage() + begin_offset;
         }
 
-        pointer CopyElements() {
-            pointer values = allocator.allocate(size);
-            for (int i = 0; i < size; i++) {
-                values[i] = list[i];
-            }
-            return values;
+        size_t GetSize() const noexcept {
+            return current_size;
         }
-    };
 
-    template <typename T, int N, typename Allocator = Allocator<T>>
-    class ChunkList : IChunkList<T> {
-    public:
-        using value_type = T;
-        using allocator_type = Allocator;
-        using size_type = std::size_t;
-        using difference_type = std::ptrdiff_t;
-        using reference = value_type&;
-        using const_reference = const value_type&;
-        using iterator = ChunkList_iterator<value_type>;
-        using const_iterator = ChunkList_const_iterator<value_type>;
+        int GetFreeSlots() const noexcept {
+            return size - begin_offset - current_size;
+        }
 
-    private:
-        int size = 0;
-        Chunk<value_type>* start = nullptr;
+        reference at(size_type position) {
+            if (position >= static_cast<size_type>(size - begin_offset)) {
+                throw std::out_of_range("out of range");
+            }
+            return data()[position];
+        }
 
-    public:
+        reference operator[](difference_type position) noexcept {
+            return data()[position];
+        }
+    };
 
-        ChunkList() : start(new Chunk<value_type>(N)) {}
+    template <typename T, std::size_t Bytes = 4096>
+    inline constexpr int chunk_capacity_for_bytes =
+            Bytes > sizeof(Chunk<T>) + sizeof(T) ? static_cast<int>((Bytes - sizeof(Chunk<T>)) / sizeof(T)) : 1;
 
-        explicit ChunkList(const Allocator& alloc) : start(new Chunk<value_type>(N, alloc)) {}
+    inline constexpr int dynamic_chunk_size = 0;
 
-        size_t GetSize() const noexcept override {
-            return size;
+    template <int N>
+    class StaticChunkSizing {
+    public:
+        static constexpr bool IsGeometric() noexcept {
+            return false;
         }
 
-        ChunkList(size_type count, const T& value = T(), const Allocator& alloc = Allocator()) : start(new Chunk<value_type>(N))
-        {
-            Chunk<value_type>* temp_pointer = start;
-            bool flag = false;
-            while (size < count) {
-                temp_pointer->allocator = alloc;
-                for (int j = 0; j < N; j++) {
-                    temp_pointer->list[j] = value;
-                    temp_pointer->current_size++;
-                    size++;
-                    if (size >= count) {
-                        flag = true;
-                        break;
-                    }
-                }
-                if (flag) {
-                    return;
-                }
-                Chunk<value_type>* pointer_prev = temp_pointer;
-                temp_pointer->next = new Chunk<value_type>(N, alloc);
-                temp_pointer = temp_pointer->next;
-                temp_pointer->prev = pointer_prev;
-            }
+        static constexpr int SizeOf(std::size_t) noexcept {
+            return N;
         }
 
-        explicit ChunkList(size_type count, const Allocator& alloc = Allocator()) : start(new Chunk<value_type>(N))
-        {
-            Chunk<value_type>* temp_pointer = start;
-            bool flag = false;
-            while (size < count) {
-                temp_pointer->allocator = alloc;
-                for (int j = 0; j < N; j++) {
-                    temp_pointer->list[j] = value_type();
-                    temp_pointer->current_size++;
-                    size++;
-                    if (size >= count) {
-                        flag = true;
-                        break;
-                    }
-                }
-                if (flag) {
-                    return;
-                }
-                Chunk<value_type>* pointer_prev = temp_pointer;
-                temp_pointer->next = new Chunk<value_type>(N, alloc);
-                temp_pointer = temp_pointer->next;
-                temp_pointer->prev = pointer_prev;
-            }
+        static constexpr std::size_t Find(std::size_t position, int& offset) noexcept {
+            offset = static_cast<int>(position % N);
+            return position / N;
         }
+    };
 
-        ChunkList(const ChunkList& other) : start(new Chunk<value_type>(N)) {
-            Chunk<value_type>* other_list = other.start;
-            Chunk<value_type>* this_list = start;
-            size = other.size;
-            while (other_list != nullptr) {
-                this_list->current_size = other_list->current_size;
-                this_list->list = other_list->CopyElements();
-                this_list->next = new Chunk<value_type>(N);
-                Chunk<value_type>* temp_pointer = this_list;
-                this_list = this_list->next;
-                this_list->prev = temp_pointer;
-                other_list = other_list->next;
+    class ChunkSizing {
+    public:
+        ChunkSizing() noexcept : first(64), limit(64) {}
+
+        explicit ChunkSizing(int chunk_size) : first(chunk_size), limit(chunk_size) {
+            if (chunk_size <= 0) {
+                throw std::invalid_argument("chunk size must be positive");
             }
         }
 
-        ChunkList(const ChunkList& other, const Allocator& alloc) : start(new Chunk<value_type>(N, alloc)) {
-            Chunk<value_type>* other_list = other.start;
-            Chunk<value_type>* this_list = start;
-            size = other.size;
-            while (other_list != nullptr) {
-                this_list->current_size = other_list->current_size;
-                this_list->list = other_list->CopyElements();
-                this_list->next = new Chunk<value_type>(N, alloc);
-                Chunk<value_type>* temp_pointer = this_list;
-                this_list = this_list->next;
-                this_list->prev = temp_pointer;
-                other_list = other_list->next;
+        static ChunkSizing Geometric(int first, int limit) {
+            if (first <= 0 || first > limit || !std::has_single_bit(static_cast<unsigned>(first)) ||
+                !std::has_single_bit(static_cast<unsigned>(limit))) {
+                throw std::invalid_argument("geometric chunk sizes must be powers of two");
             }
+            ChunkSizing sizing(first);
+            sizing.limit = limit;
+            sizing.first_shift = std::countr_zero(static_cast<unsigned>(first));
+            sizing.limit_shift = std::countr_zero(static_cast<unsigned>(limit));
+            sizing.levels = sizing.limit_shift - sizing.first_shift;
+            return sizing;
         }
 
-        ChunkList(ChunkList&& other) {
-            size = std::move(other.size);
-            start = std::move(other.start);
-            other.clear();
+        bool IsGeometric() const noexcept {
+            return first != limit;
         }
 
-        ChunkList(ChunkList&& other, const Allocator& alloc) {
-            this = ChunkList(other);
-            Chunk<value_type>* temp_pointer = this->start;
-            while (temp_pointer != nullptr) {
-                temp_pointer->allocator = alloc;
-                temp_pointer = temp_pointer->next;
-            }
+        int GetFirst() const noexcept {
+            return first;
         }
 
-        ~ChunkList() {
-            clear();
+        int GetLimit() const noexcept {
+            return limit;
         }
 
-        ChunkList& operator=(const ChunkList& other) {
-            this = new ChunkList(other);
-            return *this;
+        int SizeOf(std::size_t number) const noexcept {
+            return number < levels ? first << number : limit;
         }
 
-        ChunkList& operator=(ChunkList&& other) {
-            size = std::move(other.size);
-            start = std::move(other.start);
-            other.clear();
-            return *this;
+        std::size_t Find(std::size_t position, int& offset) const noexcept {
+            if (!IsGeometric()) {
+                offset = static_cast<int>(position % first);
+                return position / first;
+            }
+            std::size_t grown = limit - first;
+            if (position < grown) {
+                std::size_t number = std::bit_width((position >> first_shift) + 1) - 1;
+                offset = static_cast<int>(position - ((static_cast<std::size_t>(first) << number) - first));
+                return number;
+            }
+            position -= grown;
+            offset = static_cast<int>(position & (limit - 1));
+            return levels + (position >> limit_shift);
         }
 
-        void assign(size_type count, const T& value) {
-            if (count > 0) {
-                clear();
-                for (int i = 0; i < count; i++) {
-                    push_back(value);
-                }
-                size = count;
-            }
+    private:
+        int first;
+        int limit;
+        int first_shift = 0;
+        int limit_shift = 0;
+        std::size_t levels = 0;
+    };
+
+    template <typename ValueType, typename Allocator = Allocator<ValueType>>
+    class ChunkPool {
+    public:
+        using size_type = std::size_t;
+        using allocator_type = Allocator;
+
+        static constexpr size_type default_high_water_mark = 4;
+
+        explicit ChunkPool(size_type high_water_mark = default_high_water_mark,
+                           const Allocator& alloc = Allocator()) noexcept :
+                high_water_mark(high_water_mark), allocator(alloc) {}
+
+        ChunkPool(const ChunkPool& other) = delete;
+
+        ChunkPool& operator=(const ChunkPool& other) = delete;
+
+        ~ChunkPool() {
+            Trim(0);
         }
 
-        allocator_type get_allocator() const noexcept {
-            return start->allocator;
+        static ChunkPool& ThreadLocal() {
+            static thread_local ChunkPool pool(64);
+            return pool;
         }
 
-        reference at(size_type pos) override {
-            if (pos < 0 || pos >= max_size()) {
-                throw std::out_of_range("out of range");
+        Chunk<ValueType>* Acquire(int chunk_size) {
+            if (Chunk<ValueType>* chunk = TryAcquire(chunk_size)) {
+                return chunk;
             }
-            int chunk_number = pos / N;
-            int value_number = pos % N;
-            Chunk<value_type>* temp_pointer = start;
-            for (int i = 0; i < chunk_number; i++) {
-                temp_pointer = temp_pointer->next;
-            }
-            return temp_pointer->at(value_number);
+            misses++;
+            return Create(chunk_size);
         }
 
-        const_reference at(size_type pos) const
-        {
-            if (pos < 0 || pos >= max_size()) {
-                throw std::out_of_range("out of range");
+        // The cached chunk at the head of the free list if it has chunk_size
+        // slots, otherwise nullptr; never allocates.
+        Chunk<ValueType>* TryAcquire(int chunk_size) noexcept {
+            if (free_list == nullptr || free_list->size != chunk_size) {
+                return nullptr;
             }
-            int chunk_number = pos / N;
-            int value_number = pos % N;
-            Chunk<value_type>* temp_pointer = start;
-            for (int i = 0; i < chunk_number; i++) {
-                temp_pointer = temp_pointer->next;
+            Chunk<ValueType>* chunk = free_list;
+            free_list = chunk->next;
+            chunk->next = nullptr;
+            cached--;
+            cached_slots -= chunk_size;
+            hits++;
+            return chunk;
+        }
+
+        void Release(Chunk<ValueType>* chunk) noexcept {
+            if (cached >= high_water_mark) {
+                Destroy(chunk);
+                return;
             }
-            return const_cast<reference>(temp_pointer->at(value_number));
-        }
-
-        reference operator[](difference_type pos) override {
-            int chunk_number = pos / N;
-            int value_number = pos % N;
-            Chunk<value_type>* temp_pointer = start;
-            for (int i = 0; i < chunk_number; i++) {
-                temp_pointer = temp_pointer->next;
+            chunk->current_size = 0;
+            chunk->begin_offset = 0;
+            chunk->references = 1;
+            chunk->prev = nullptr;
+            chunk->next = free_list;
+            free_list = chunk;
+            cached++;
+            cached_slots += chunk->size;
+        }
+
+        // Views are a single header block and never enter the free list.
+        Chunk<ValueType>* AcquireView(Chunk<ValueType>* owner) {
+            Chunk<ValueType>* view = Create(0);
+            view->size = owner->size;
+            view->owner = owner;
+            return view;
+        }
+
+        void ReleaseView(Chunk<ValueType>* view) noexcept {
+            block_allocator blocks(allocator);
+            view->~Chunk();
+            block_traits::deallocate(blocks, reinterpret_cast<block_type*>(view), Chunk<ValueType>::BlockCount(0));
+        }
+
+        // Caches count new chunks behind the first position cached ones, the
+        // i-th of them chunk_size(i) slots long, so chunks already lined up
+        // for the next Acquire calls keep their place.
+        template <typename SizeOf>
+        void Reserve(size_type position, size_type count, SizeOf chunk_size) {
+            Chunk<ValueType>** link = &free_list;
+            for (size_type i = 0; i < position; i++) {
+                link = &(*link)->next;
             }
-            return temp_pointer->list[value_number];
-        }
-
-        const_reference operator[](difference_type pos) const
-        {
-            int chunk_number = pos / N;
-            int value_number = pos % N;
-            Chunk<value_type>* temp_pointer = start;
-            for (int i = 0; i < chunk_number; i++) {
-                temp_pointer = temp_pointer->next;
+            for (size_type i = 0; i < count; i++) {
+                int size = chunk_size(i);
+                Chunk<ValueType>* chunk = Create(size);
+                chunk->next = *link;
+                *link = chunk;
+                link = &chunk->next;
+                cached++;
+                cached_slots += size;
             }
-            return const_cast<reference>(temp_pointer->list[value_number]);
-        }
-
-        reference front() {
-            if (size > 0)
-                return start->list[0];
-            else
-                throw std::runtime_error("empty");
         }
 
-        const_reference front() const {
-            if (size > 0) {
-                static_cast<reference>(start->list[0]);
+        // How many chunks at the head of the free list are chunk_size(0),
+        // chunk_size(1), ... slots long, that is, how many Acquire calls
+        // asking for those sizes in turn would be served from the cache.
+        template <typename SizeOf>
+        size_type CountLinedUp(SizeOf chunk_size) const noexcept {
+            size_type count = 0;
+            for (Chunk<ValueType>* chunk = free_list; chunk != nullptr && chunk->size == chunk_size(count);
+                 chunk = chunk->next) {
+                count++;
             }
-            else throw std::runtime_error("empty");
+            return count;
         }
 
-        reference back() {
-            if (size == 0) {
-                throw std::runtime_error("empty");
+        void Trim(size_type keep) noexcept {
+            while (cached > keep) {
+                Chunk<ValueType>* chunk = free_list;
+                free_list = chunk->next;
+                cached_slots -= chunk->size;
+                Destroy(chunk);
+                cached--;
             }
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
-            }
-            return temp_pointer->list[temp_pointer->current_size - 1];
         }
 
-        const_reference back() const {
-            if (size == 0) {
-                throw std::runtime_error("empty");
-            }
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
-            }
-            return const_cast<reference>(temp_pointer->list[temp_pointer->current_size - 1]);
+        void SetHighWaterMark(size_type mark) noexcept {
+            high_water_mark = mark;
+            Trim(mark);
         }
 
-        iterator begin() noexcept {
-            if (size == 0) {
-                return end();
-            }
-            return ChunkList_iterator<value_type>(&at(0), 0, this);
+        size_type GetHighWaterMark() const noexcept {
+            return high_water_mark;
         }
 
-        const_iterator begin() const noexcept {
-            if (size == 0) {
-                return end();
-            }
-            return ChunkList_const_iterator<value_type>(&at(0), 0, this);
+        size_type GetCached() const noexcept {
+            return cached;
         }
 
-        const_iterator cbegin() const noexcept {
-            return begin();
+        size_type GetCachedSlots() const noexcept {
+            return cached_slots;
         }
 
-        iterator end() noexcept {
-            return ChunkList_iterator<value_type>();
+        size_type GetHits() const noexcept {
+            return hits;
         }
 
-        const_iterator end() const noexcept {
-            return ChunkList_const_iterator<value_type>();
+        size_type GetMisses() const noexcept {
+            return misses;
         }
 
-        const_iterator cend() const noexcept {
-            return end();
+        allocator_type get_allocator() const noexcept {
+            return allocator;
         }
 
-        bool empty() const noexcept {
-            return size == 0;
+        allocator_type& AllocatorRef() noexcept {
+            return allocator;
         }
 
-        int get_size() const noexcept {
-            return size;
+        void swap(ChunkPool& other) noexcept {
+            using std::swap;
+            swap(allocator, other.allocator);
+            std::swap(free_list, other.free_list);
+            std::swap(cached, other.cached);
+            std::swap(cached_slots, other.cached_slots);
+            std::swap(high_water_mark, other.high_water_mark);
+            std::swap(hits, other.hits);
+            std::swap(misses, other.misses);
         }
 
-        size_type max_size() const noexcept {
-            size_type value_number = size % N;
-            return (value_number == 0 ? size : size + N - value_number);
+    private:
+        Chunk<ValueType>* free_list = nullptr;
+        size_type cached = 0;
+        size_type cached_slots = 0;
+        size_type high_water_mark = default_high_water_mark;
+        size_type hits = 0;
+        size_type misses = 0;
+        [[no_unique_address]] Allocator allocator;
+
+        using block_type = typename Chunk<ValueType>::block_type;
+        using block_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<block_type>;
+        using block_traits = std::allocator_traits<block_allocator>;
+
+        Chunk<ValueType>* Create(int chunk_size) {
+            block_allocator blocks(allocator);
+            block_type* memory = block_traits::allocate(blocks, Chunk<ValueType>::BlockCount(chunk_size));
+            return ::new (static_cast<void*>(memory)) Chunk<ValueType>(chunk_size);
+        }
+
+        void Destroy(Chunk<ValueType>* chunk) noexcept {
+            block_allocator blocks(allocator);
+            size_type block_count = Chunk<ValueType>::BlockCount(chunk->size);
+            chunk->~Chunk();
+            block_traits::deallocate(blocks, reinterpret_cast<block_type*>(chunk), block_count);
         }
+    };
 
-        void clear() noexcept {
-            Chunk<value_type>* current_chunk = start;
-            while (current_chunk != nullptr) {
-                Chunk<value_type>* temp_pointer = current_chunk;
-                current_chunk = current_chunk->next;
-                delete temp_pointer;
+    template <typename ElementType>
+    class ChunkList_segments {
+    public:
+        using value_type = std::span<ElementType>;
+        using chunk_type = Chunk<std::remove_const_t<ElementType>>;
+
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::span<ElementType>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = std::span<ElementType>;
+
+            iterator() noexcept = default;
+
+            explicit iterator(chunk_type* current_chunk, ChunkUnsharer<std::remove_const_t<ElementType>> chunk_unsharer = {}) :
+                    chunk(current_chunk), unsharer(chunk_unsharer) {
+                Own();
             }
-            start = nullptr;
-            size = 0;
-        }
 
-        iterator insert(const_iterator pos, const T& value) {
-            if (pos == cend())
-                return end();
-            int index = pos.GetIndex();
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
+            reference operator*() const noexcept {
+                return reference(chunk->data(), chunk->current_size);
             }
-            ChunkList_iterator<value_type> iterator(&temp_pointer->
-                    list[temp_pointer->current_size - 1], size - 1, this);
-            if (size < max_size()) {
-                for (int i = 0; iterator >= pos; i++, iterator--) {
-                    at(size - i) = at(size - i - 1);
-                }
-                size++;
+
+            iterator& operator++() {
+                Step();
+                return *this;
             }
-            else {
-                temp_pointer->next = new Chunk<value_type>(N);
-                Chunk<value_type>* prev_chunk = temp_pointer;
-                temp_pointer = temp_pointer->next;
-                temp_pointer->prev = prev_chunk;
-                size++;
-                for (int i = 0; iterator >= pos; i++, iterator--) {
-                    at(size - i - 1) = at(size - i - 2);
-                }
+
+            iterator operator++(int) {
+                iterator previous = *this;
+                Step();
+                return previous;
             }
-            at(index) = value;
-            temp_pointer->current_size++;
-            return ChunkList_iterator<value_type>(&at(index), index, this);
-        }
 
-        iterator insert(const_iterator pos, T&& value) {
-            if (pos == cend())
-                return end();
-            int index = pos.GetIndex();
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
+            friend bool operator==(const iterator& first, const iterator& second) noexcept {
+                return first.chunk == second.chunk;
             }
-            ChunkList_iterator<value_type> iterator(&temp_pointer->
-                    list[temp_pointer->current_size - 1], size - 1, this);
-            if (size < max_size()) {
-                for (int i = 0; iterator >= pos; i++, iterator--) {
-                    at(size - i) = at(size - i - 1);
-                }
-                size++;
+
+        private:
+            chunk_type* chunk = nullptr;
+            std::ptrdiff_t index = 0;
+            ChunkUnsharer<std::remove_const_t<ElementType>> unsharer;
+
+            void Step() {
+                index += chunk->current_size;
+                chunk = chunk->next;
+                Own();
             }
-            else {
-                temp_pointer->next = new Chunk<value_type>(N);
-                Chunk<value_type>* prev_chunk = temp_pointer;
-                temp_pointer = temp_pointer->next;
-                temp_pointer->prev = prev_chunk;
-                size++;
-                for (int i = 0; iterator >= pos; i++, iterator--) {
-                    at(size - i - 1) = at(size - i - 2);
+
+            void Own() {
+                if (chunk != nullptr) {
+                    chunk = unsharer(chunk, index);
                 }
             }
-            at(index) = std::move(value);
-            temp_pointer->current_size++;
-            return ChunkList_iterator<value_type>(&at(index), index, this);
+        };
+
+        explicit ChunkList_segments(chunk_type* start,
+                                    ChunkUnsharer<std::remove_const_t<ElementType>> unsharer = {}) noexcept :
+                start(start), unsharer(unsharer) {}
+
+        iterator begin() const {
+            return iterator(start, unsharer);
         }
 
-        iterator erase(const_iterator pos) {
-            int index = pos.GetIndex();
-            if (index + 1 == size) {
-                size--;
-                return ChunkList_iterator<value_type>();
+        iterator end() const noexcept {
+            return iterator();
+        }
+
+    private:
+        chunk_type* start = nullptr;
+        ChunkUnsharer<std::remove_const_t<ElementType>> unsharer;
+    };
+
+    // Chunk pointers in a deque-like array plus a Fenwick tree over the sizes
+    // of every chunk but the tail, so positions map to chunks in O(log n)
+    // even when chunks are partly filled. The tail is left out because
+    // appends change its size without telling the directory. Update(number)
+    // patches one chunk's size in O(log n). Chunks appended past the tree are
+    // read lazily on the next Find. Inserting or erasing chunks in the middle
+    // shifts the arrays and leaves the tree valid only up to that position;
+    // the rest is recomputed on the next Find, in O(log n) per node when it is
+    // short and in one linear pass otherwise. erase(position, count) drops a
+    // whole run of chunks with one shift.
+    template <typename ValueType, typename Allocator = Allocator<ValueType>>
+    class ChunkDirectory {
+    public:
+        using size_type = std::size_t;
+        using chunk_pointer = Chunk<ValueType>*;
+
+        explicit ChunkDirectory(const Allocator& alloc = Allocator()) noexcept :
+                allocator(alloc), size_allocator(alloc) {}
+
+        ChunkDirectory(const ChunkDirectory& other) = delete;
+
+        ChunkDirectory& operator=(const ChunkDirectory& other) = delete;
+
+        ~ChunkDirectory() {
+            if (storage != &first) {
+                pointer_traits::deallocate(allocator, storage, capacity);
+                size_traits::deallocate(size_allocator, sizes, capacity);
+                size_traits::deallocate(size_allocator, tree, capacity + 1);
             }
-            for (int i = index + 1; index < size; i++) {
-                at(i - 1) = at(i);
+        }
+
+        chunk_pointer operator[](size_type position) const noexcept {
+            return chunks[position];
+        }
+
+        size_type GetSize() const noexcept {
+            return count;
+        }
+
+        void push_back(chunk_pointer chunk) {
+            if (head + count == capacity) {
+                MakeRoom(false);
             }
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
+            chunks[count++] = chunk;
+        }
+
+        void reserve(size_type required) {
+            if (head + required > capacity) {
+                Rebase(std::max(required, capacity), 0);
             }
-            if (size == max_size() - N + 1) {
-                temp_pointer = temp_pointer->prev;
-                delete temp_pointer->next;
-                temp_pointer->next = nullptr;
+        }
+
+        void pop_back() noexcept {
+            count--;
+            Clip();
+        }
+
+        void insert(size_type position, chunk_pointer chunk) {
+            if (position == 0 && count != 0) {
+                if (head == 0) {
+                    MakeRoom(true);
+                }
+                chunks--;
+                head--;
             }
             else {
-                temp_pointer->current_size--;
+                if (head + count == capacity) {
+                    MakeRoom(false);
+                }
+                std::memmove(chunks + position + 1, chunks + position, (count - position) * sizeof(chunk_pointer));
             }
-            size--;
-            return ChunkList_iterator<value_type>(&at(index), index, this);
-        }
-
-        iterator erase(const_iterator first, const_iterator last) {
-            int index = last.GetIndex();
-            auto iterator = (*this).begin();
-            int end = 1;
-            int range_length = 0;
-            for (; iterator != first; iterator++, end++);
-            for (iterator = first; iterator != last; iterator++, end++, range_length++);
-            for (; end < size; end++) {
-                at(end - range_length) = at(end);
-            }
-            size -= range_length;
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
-            }
-            while (range_length > 0) {
-                if (temp_pointer->current_size > 0) {
-                    temp_pointer->current_size--;
-                    range_length--;
+            chunks[position] = chunk;
+            count++;
+            if (position < known) {
+                std::memmove(sizes + position + 1, sizes + position, (known - position) * sizeof(size_type));
+                known++;
+                built = std::min(built, position);
+                if (stale_first < stale_last) {
+                    if (position <= stale_first) {
+                        stale_first++;
+                        stale_last++;
+                    }
+                    else if (position < stale_last) {
+                        stale_last++;
+                    }
+                    stale_first = std::min(stale_first, position);
+                    stale_last = std::max(stale_last, position + 1);
                 }
                 else {
-                    temp_pointer = temp_pointer->prev;
-                    temp_pointer->next = nullptr;
+                    stale_first = position;
+                    stale_last = position + 1;
                 }
             }
-            return ChunkList_iterator<value_type>(&at(index), index, this);
+            Clip();
         }
 
-        void push_back(const T& value) {
-            if (start == nullptr) {
-                start = new Chunk<value_type>(N);
+        void erase(size_type position, size_type removed = 1) noexcept {
+            if (position == 0) {
+                chunks += removed;
+                head += removed;
             }
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
+            else {
+                std::memmove(chunks + position, chunks + position + removed,
+                             (count - position - removed) * sizeof(chunk_pointer));
             }
-            if (temp_pointer->current_size == temp_pointer->size) {
-                temp_pointer->next = new Chunk<value_type>(N);
-                Chunk<value_type>* prev_pointer = temp_pointer;
-                temp_pointer = temp_pointer->next;
-                temp_pointer->prev = prev_pointer;
+            count -= removed;
+            if (position < known) {
+                size_type kept = std::min(known, position + removed);
+                std::memmove(sizes + position, sizes + kept, (known - kept) * sizeof(size_type));
+                known -= kept - position;
+                built = std::min(built, position);
+                stale_first = Shift(stale_first, position, removed);
+                stale_last = Shift(stale_last, position, removed);
             }
-            temp_pointer->list[temp_pointer->current_size] = value;
-            temp_pointer->current_size++;
-            size++;
+            Clip();
         }
 
-        void push_back(T&& value) {
-            if (start == nullptr) {
-                start = new Chunk<value_type>(N);
+        void clear() noexcept {
+            chunks = storage;
+            head = 0;
+            count = 0;
+            known = 0;
+            built = 0;
+            stale_first = 0;
+            stale_last = 0;
+        }
+
+        // The sizes of this chunk and of everything after it may have changed.
+        void Invalidate(size_type position) noexcept {
+            known = std::min(known, position);
+            Clip();
+        }
+
+        // Only this chunk's size changed.
+        void Update(size_type position) noexcept {
+            if (position >= known || (position >= stale_first && position < stale_last)) {
+                return;
+            }
+            size_type current = chunks[position]->current_size;
+            if (position < built) {
+                for (size_type node = position + 1; node <= known; node += node & (0 - node)) {
+                    tree[node] += current - sizes[position];
+                }
+            }
+            sizes[position] = current;
+        }
+
+        void Replace(size_type position, chunk_pointer chunk) noexcept {
+            chunks[position] = chunk;
+        }
+
+        // Returns the chunk that holds element and its offset there.
+        size_type Find(size_type element, int& offset) const noexcept {
+            Refresh();
+            size_type number = 0;
+            for (size_type step = std::bit_floor(known); step > 0; step >>= 1) {
+                if (number + step <= known && tree[number + step] <= element) {
+                    number += step;
+                    element -= tree[number];
+                }
+            }
+            offset = static_cast<int>(element);
+            return number;
+        }
+
+        void swap(ChunkDirectory& other) noexcept {
+            std::swap(first, other.first);
+            std::swap(storage, other.storage);
+            std::swap(chunks, other.chunks);
+            std::swap(head, other.head);
+            std::swap(sizes, other.sizes);
+            std::swap(tree, other.tree);
+            std::swap(count, other.count);
+            std::swap(known, other.known);
+            std::swap(built, other.built);
+            std::swap(stale_first, other.stale_first);
+            std::swap(stale_last, other.stale_last);
+            std::swap(capacity, other.capacity);
+            TakeFirst(other);
+            other.TakeFirst(*this);
+        }
+
+        void SwapAllocator(ChunkDirectory& other) noexcept {
+            using std::swap;
+            swap(allocator, other.allocator);
+            swap(size_allocator, other.size_allocator);
+        }
+
+    private:
+        using pointer_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<chunk_pointer>;
+        using pointer_traits = std::allocator_traits<pointer_allocator>;
+        using size_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<size_type>;
+        using size_traits = std::allocator_traits<size_allocator_type>;
+
+        // A directory of one chunk keeps the pointer in first and allocates
+        // nothing. sizes and tree are not needed until there are two chunks.
+        chunk_pointer first = nullptr;
+        chunk_pointer* storage = &first;
+        chunk_pointer* chunks = &first;
+        size_type head = 0;
+        mutable size_type* sizes = nullptr;
+        mutable size_type* tree = nullptr;
+        size_type count = 0;
+        mutable size_type known = 0;
+        // Tree nodes 1..built are up to date; built never exceeds known.
+        mutable size_type built = 0;
+        mutable size_type stale_first = 0;
+        mutable size_type stale_last = 0;
+        size_type capacity = 1;
+        [[no_unique_address]] pointer_allocator allocator;
+        [[no_unique_address]] size_allocator_type size_allocator;
+
+        void TakeFirst(const ChunkDirectory& other) noexcept {
+            if (storage == &other.first) {
+                storage = &first;
+                chunks = storage + head;
+            }
+        }
+
+        void Clip() const noexcept {
+            known = std::min(known, count == 0 ? 0 : count - 1);
+            built = std::min(built, known);
+            stale_last = std::min(stale_last, known);
+            if (stale_first >= stale_last) {
+                stale_first = 0;
+                stale_last = 0;
+            }
+        }
+
+        void Refresh() const noexcept {
+            size_type indexed = count == 0 ? 0 : count - 1;
+            if (stale_first < stale_last) {
+                for (size_type i = stale_first; i < stale_last; i++) {
+                    sizes[i] = chunks[i]->current_size;
+                }
+                built = std::min(built, stale_first);
+                stale_first = 0;
+                stale_last = 0;
+            }
+            if (built == indexed) {
+                return;
+            }
+            for (size_type i = known; i < indexed; i++) {
+                sizes[i] = chunks[i]->current_size;
+            }
+            if ((indexed - built) * 16 > indexed) {
+                for (size_type node = 1; node <= indexed; node++) {
+                    tree[node] = sizes[node - 1];
+                }
+                for (size_type node = 1; node <= indexed; node++) {
+                    size_type parent = node + (node & (0 - node));
+                    if (parent <= indexed) {
+                        tree[parent] += tree[node];
+                    }
+                }
+            }
+            else {
+                for (size_type node = built + 1; node <= indexed; node++) {
+                    tree[node] = sizes[node - 1];
+                    for (size_type child = 1; child < (node & (0 - node)); child <<= 1) {
+                        tree[node] += tree[node - child];
+                    }
+                }
+            }
+            known = indexed;
+            built = indexed;
+        }
+
+        // Where index lands once removed entries starting at position are gone.
+        static size_type Shift(size_type index, size_type position, size_type removed) noexcept {
+            if (index <= position) {
+                return index;
+            }
+            return index < position + removed ? position : index - removed;
+        }
+
+        void MakeRoom(bool front) {
+            size_type new_capacity = capacity;
+            if (count + 1 > capacity / 2) {
+                new_capacity = std::max<size_type>({count + 1, capacity * 2, 8});
+            }
+            Rebase(new_capacity, front ? (new_capacity - count) / 2 : 0);
+        }
+
+        void Rebase(size_type new_capacity, size_type new_head) {
+            if (new_capacity == capacity) {
+                std::memmove(storage + new_head, chunks, count * sizeof(chunk_pointer));
+                chunks = storage + new_head;
+                head = new_head;
+                return;
+            }
+            chunk_pointer* new_storage = pointer_traits::allocate(allocator, new_capacity);
+            size_type* new_sizes;
+            size_type* new_tree;
+            try {
+                new_sizes = size_traits::allocate(size_allocator, new_capacity);
+                try {
+                    new_tree = size_traits::allocate(size_allocator, new_capacity + 1);
+                }
+                catch (...) {
+                    size_traits::deallocate(size_allocator, new_sizes, new_capacity);
+                    throw;
+                }
+            }
+            catch (...) {
+                pointer_traits::deallocate(allocator, new_storage, new_capacity);
+                throw;
+            }
+            std::memcpy(new_storage + new_head, chunks, count * sizeof(chunk_pointer));
+            if (storage != &first) {
+                std::memcpy(new_sizes, sizes, known * sizeof(size_type));
+                std::memcpy(new_tree, tree, (known + 1) * sizeof(size_type));
+                pointer_traits::deallocate(allocator, storage, capacity);
+                size_traits::deallocate(size_allocator, sizes, capacity);
+                size_traits::deallocate(size_allocator, tree, capacity + 1);
+            }
+            storage = new_storage;
+            chunks = new_storage + new_head;
+            head = new_head;
+            sizes = new_sizes;
+            tree = new_tree;
+            capacity = new_capacity;
+        }
+    };
+
+    template <typename ValueType, typename Allocator = Allocator<ValueType>>
+    class NoChunkDirectory {
+    public:
+        explicit NoChunkDirectory(const Allocator& = Allocator()) noexcept {}
+
+        void push_back(Chunk<ValueType>*) noexcept {}
+
+        void pop_back() noexcept {}
+
+        void reserve(std::size_t) noexcept {}
+
+        void insert(std::size_t, Chunk<ValueType>*) noexcept {}
+
+        void erase(std::size_t, std::size_t = 1) noexcept {}
+
+        void clear() noexcept {}
+
+        void Invalidate(std::size_t) noexcept {}
+
+        void Update(std::size_t) noexcept {}
+
+        void Replace(std::size_t, Chunk<ValueType>*) noexcept {}
+
+        void swap(NoChunkDirectory&) noexcept {}
+
+        void SwapAllocator(NoChunkDirectory&) noexcept {}
+    };
+
+    template <typename T, int N, typename Allocator, bool Indexed, bool InlineFirst>
+    class ConcurrentAppender;
+
+    struct BinaryAccess;
+
+    struct MappedAccess;
+
+    struct SortAccess;
+
+    // With InlineFirst the list carries one chunk of N elements inside the
+    // object and links it before asking the pool for anything, so a list that
+    // never outgrows it makes no heap allocation at all. The block is never
+    // shared with a copy, and a move swaps it element by element.
+    template <typename T, int N, typename Allocator = Allocator<T>, bool Indexed = true, bool InlineFirst = false>
+    class ChunkList : IChunkList<T> {
+        static_assert(!InlineFirst || N != dynamic_chunk_size, "an inline chunk needs a fixed chunk size");
+        static_assert(!InlineFirst || std::is_nothrow_move_constructible_v<T>,
+                      "moving a list with an inline chunk moves its elements");
+
+        friend class ConcurrentAppender<T, N, Allocator, Indexed, InlineFirst>;
+        friend struct BinaryAccess;
+        friend struct MappedAccess;
+        friend struct SortAccess;
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using iterator = ChunkList_iterator<value_type>;
+        using const_iterator = ChunkList_const_iterator<value_type>;
+        using pool_type = ChunkPool<value_type, allocator_type>;
+        using sizing_type = std::conditional_t<N == dynamic_chunk_size, ChunkSizing, StaticChunkSizing<N>>;
+
+    private:
+        using allocator_traits = std::allocator_traits<allocator_type>;
+
+        int size = 0;
+        Chunk<value_type>* start = nullptr;
+        Chunk<value_type>* tail = nullptr;
+        size_type chunk_count = 0;
+        [[no_unique_address]] sizing_type sizing;
+        [[no_unique_address]] std::conditional_t<Indexed, ChunkDirectory<value_type, allocator_type>,
+                NoChunkDirectory<value_type, allocator_type>> directory;
+        pool_type own_pool;
+        pool_type* shared_pool = nullptr;
+        bool uniform = true;
+        mutable bool maybe_shared = false;
+
+        struct InlineBlock {
+            alignas(Chunk<T>) std::byte bytes[sizeof(Chunk<T>) + (InlineFirst ? N : 0) * sizeof(T)];
+            bool used = false;
+        };
+
+        struct NoInlineBlock {};
+
+        [[no_unique_address]] std::conditional_t<InlineFirst, InlineBlock, NoInlineBlock> inline_block;
+
+        struct Location {
+            Chunk<value_type>* chunk;
+            size_type number;
+            int offset;
+        };
+
+        pool_type& Pool() noexcept {
+            return shared_pool == nullptr ? own_pool : *shared_pool;
+        }
+
+        const pool_type& Pool() const noexcept {
+            return shared_pool == nullptr ? own_pool : *shared_pool;
+        }
+
+        // Chunks at the head of the own pool that the next appends would take.
+        size_type ReservedChunks() const noexcept {
+            return own_pool.CountLinedUp([this](size_type number) { return sizing.SizeOf(chunk_count + number); });
+        }
+
+        Location Locate(size_type pos) const noexcept {
+            if constexpr (Indexed) {
+                if (uniform) {
+                    int offset;
+                    size_type number = sizing.Find(pos + start->begin_offset, offset);
+                    if (number == 0) {
+                        offset -= start->begin_offset;
+                    }
+                    return {directory[number], number, offset};
+                }
+                int offset;
+                size_type number = directory.Find(pos, offset);
+                return {directory[number], number, offset};
+            }
+            else {
+                Chunk<value_type>* temp_pointer = start;
+                size_type number = 0;
+                while (pos >= static_cast<size_type>(temp_pointer->current_size) && temp_pointer->next != nullptr) {
+                    pos -= temp_pointer->current_size;
+                    temp_pointer = temp_pointer->next;
+                    number++;
+                }
+                return {temp_pointer, number, static_cast<int>(pos)};
+            }
+        }
+
+        Chunk<value_type>* LinkAfter(Chunk<value_type>* previous, size_type number, int chunk_size) {
+            Chunk<value_type>* chunk = AcquireChunk(chunk_size);
+            try {
+                directory.insert(number, chunk);
+            }
+            catch (...) {
+                ReleaseChunk(chunk);
+                throw;
+            }
+            chunk->prev = previous;
+            chunk->next = previous == nullptr ? start : previous->next;
+            if (chunk->next != nullptr) {
+                chunk->next->prev = chunk;
+            }
+            else {
+                tail = chunk;
+            }
+            if (previous != nullptr) {
+                previous->next = chunk;
+            }
+            else {
+                start = chunk;
+            }
+            if (sizing.IsGeometric() && number != chunk_count) {
+                uniform = false;
+            }
+            chunk_count++;
+            return chunk;
+        }
+
+        void Unlink(Chunk<value_type>* chunk, size_type number) noexcept {
+            if (chunk->prev != nullptr) {
+                chunk->prev->next = chunk->next;
+            }
+            else {
+                start = chunk->next;
+            }
+            if (chunk->next != nullptr) {
+                chunk->next->prev = chunk->prev;
+            }
+            else {
+                tail = chunk->prev;
+            }
+            if (sizing.IsGeometric() && number + 1 != chunk_count) {
+                uniform = false;
+            }
+            directory.erase(number);
+            DropChunk(chunk);
+            chunk_count--;
+        }
+
+        // Copies share chunks instead of copying elements. Anything that
+        // writes to a chunk first calls MakeUnique on it, which clones the
+        // elements when another list still holds them, or takes over the
+        // block when this list is its last holder. maybe_shared is set on both
+        // sides of a copy and only cleared by Unshare, so lists that were never
+        // copied skip all of this. As with any copy-on-write container, a
+        // reference or iterator taken before a copy must not be written
+        // through afterwards.
+        static bool IsShared(const Chunk<value_type>* chunk) noexcept {
+            return chunk->owner != chunk ||
+                   std::atomic_ref<int>(chunk->owner->references).load(std::memory_order_acquire) > 1;
+        }
+
+        void DropChunk(Chunk<value_type>* chunk) noexcept {
+            Chunk<value_type>* owner = chunk->owner;
+            if (owner != chunk) {
+                Pool().ReleaseView(chunk);
+            }
+            std::atomic_ref<int> references(owner->references);
+            if (references.load(std::memory_order_acquire) == 1 ||
+                references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                DestroyRange(owner->data(), owner->data() + owner->current_size);
+                ReleaseChunk(owner);
+            }
+        }
+
+        Chunk<value_type>* AcquireChunk(int chunk_size) {
+            if constexpr (InlineFirst) {
+                if (!inline_block.used && chunk_size == N) {
+                    inline_block.used = true;
+                    return ::new (static_cast<void*>(inline_block.bytes)) Chunk<value_type>(N);
+                }
+            }
+            if (shared_pool != nullptr) {
+                if (Chunk<value_type>* chunk = own_pool.TryAcquire(chunk_size)) {
+                    return chunk;
+                }
+            }
+            return Pool().Acquire(chunk_size);
+        }
+
+        void ReleaseChunk(Chunk<value_type>* chunk) noexcept {
+            if constexpr (InlineFirst) {
+                if (IsInline(chunk)) {
+                    inline_block.used = false;
+                    return;
+                }
+            }
+            Pool().Release(chunk);
+        }
+
+        bool IsInline(const Chunk<value_type>* chunk) const noexcept {
+            if constexpr (InlineFirst) {
+                return chunk == reinterpret_cast<const Chunk<value_type>*>(inline_block.bytes);
+            }
+            else {
+                return false;
+            }
+        }
+
+        Chunk<value_type>* CloneChunk(const Chunk<value_type>* chunk) {
+            Chunk<value_type>* copy = AcquireChunk(chunk->size);
+            copy->begin_offset = chunk->begin_offset;
+            if constexpr (std::is_trivially_copyable_v<value_type>) {
+                std::memcpy(static_cast<void*>(copy->data()), chunk->data(), chunk->current_size * sizeof(value_type));
+            }
+            else if constexpr (std::is_copy_constructible_v<value_type>) {
+                try {
+                    for (; copy->current_size < chunk->current_size; copy->current_size++) {
+                        ConstructAt(copy->data() + copy->current_size, chunk->data()[copy->current_size]);
+                    }
+                }
+                catch (...) {
+                    DestroyRange(copy->data(), copy->data() + copy->current_size);
+                    ReleaseChunk(copy);
+                    throw;
+                }
+            }
+            copy->current_size = chunk->current_size;
+            return copy;
+        }
+
+        Chunk<value_type>* MakeUnique(Chunk<value_type>* chunk, size_type number) {
+            if (!IsShared(chunk)) {
+                return chunk;
+            }
+            Chunk<value_type>* owner = chunk->owner;
+            Chunk<value_type>* copy = owner;
+            if (std::atomic_ref<int>(owner->references).load(std::memory_order_acquire) > 1) {
+                copy = CloneChunk(chunk);
+            }
+            copy->current_size = chunk->current_size;
+            copy->begin_offset = chunk->begin_offset;
+            copy->prev = chunk->prev;
+            copy->next = chunk->next;
+            if (copy->prev != nullptr) {
+                copy->prev->next = copy;
+            }
+            else {
+                start = copy;
+            }
+            if (copy->next != nullptr) {
+                copy->next->prev = copy;
+            }
+            else {
+                tail = copy;
+            }
+            directory.Replace(number, copy);
+            if (copy == owner) {
+                Pool().ReleaseView(chunk);
+            }
+            else {
+                DropChunk(chunk);
+            }
+            return copy;
+        }
+
+        // Non-const iterators and segment views clone a shared chunk when they
+        // step onto it rather than the whole list up front, so chunks they
+        // never reach stay shared. They hold on to this list, so they must
+        // not outlive a move or swap of it when they are used to write.
+        static Chunk<value_type>* OwnChunk(void* self, Chunk<value_type>* chunk, std::ptrdiff_t first_index) {
+            if (!IsShared(chunk)) {
+                return chunk;
+            }
+            ChunkList& list = *static_cast<ChunkList*>(self);
+            return list.MakeUnique(chunk, list.NumberOf(chunk, first_index));
+        }
+
+        size_type NumberOf(const Chunk<value_type>* chunk, std::ptrdiff_t first_index) const noexcept {
+            if constexpr (Indexed) {
+                if (chunk == start) {
+                    return 0;
+                }
+                if (chunk == tail) {
+                    return chunk_count - 1;
+                }
+                // Empty chunks share their first index with a neighbour, so
+                // look on both sides of the one Locate finds.
+                size_type number = Locate(std::min(static_cast<size_type>(first_index),
+                                                   static_cast<size_type>(size) - 1)).number;
+                size_type before = number;
+                while (before > 0 && directory[before] != chunk) {
+                    before--;
+                }
+                if (directory[before] == chunk) {
+                    return before;
+                }
+                while (directory[number] != chunk) {
+                    number++;
+                }
+                return number;
+            }
+            else {
+                return 0;
+            }
+        }
+
+        ChunkUnsharer<value_type> Unsharer() noexcept {
+            if (!maybe_shared) {
+                return {};
+            }
+            return {this, &OwnChunk};
+        }
+
+        void Unshare() {
+            if (!maybe_shared) {
+                return;
+            }
+            size_type number = 0;
+            for (Chunk<value_type>* chunk = start; chunk != nullptr; chunk = chunk->next, number++) {
+                chunk = MakeUnique(chunk, number);
+            }
+            maybe_shared = false;
+        }
+
+        bool SharesChunks() const noexcept {
+            if (maybe_shared) {
+                for (Chunk<value_type>* chunk = start; chunk != nullptr; chunk = chunk->next) {
+                    if (IsShared(chunk)) {
+                        return true;
+                    }
+                }
+                maybe_shared = false;
+            }
+            return false;
+        }
+
+        void ShareChunks(const ChunkList& other) {
+            clear();
+            maybe_shared = true;
+            other.maybe_shared = true;
+            directory.reserve(other.chunk_count);
+            for (Chunk<value_type>* chunk = other.start; chunk != nullptr; chunk = chunk->next) {
+                Chunk<value_type>* view;
+                if (other.IsInline(chunk)) {
+                    view = CloneChunk(chunk);
+                }
+                else {
+                    view = Pool().AcquireView(chunk->owner);
+                    std::atomic_ref<int>(chunk->owner->references).fetch_add(1, std::memory_order_relaxed);
+                    view->current_size = chunk->current_size;
+                    view->begin_offset = chunk->begin_offset;
+                }
+                view->prev = tail;
+                if (tail != nullptr) {
+                    tail->next = view;
+                }
+                else {
+                    start = view;
+                }
+                tail = view;
+                directory.push_back(view);
+                chunk_count++;
+                size += view->current_size;
+            }
+            uniform = other.uniform;
+        }
+
+        Chunk<value_type>* AppendChunk() {
+            return LinkAfter(tail, chunk_count, sizing.SizeOf(chunk_count));
+        }
+
+        void ReleaseTail() noexcept {
+            Unlink(tail, chunk_count - 1);
+        }
+
+        void Relocate(value_type* destination, value_type* source, int count) noexcept {
+            if constexpr (std::is_trivially_copyable_v<value_type>) {
+                std::memmove(static_cast<void*>(destination), source, count * sizeof(value_type));
+            }
+            else {
+                for (int i = 0; i < count; i++) {
+                    ConstructAt(destination + i, std::move(source[i]));
+                    DestroyRange(source + i, source + i + 1);
+                }
+            }
+        }
+
+        void OpenGap(Chunk<value_type>* chunk, int offset) noexcept {
+            value_type* data = chunk->data();
+            int count = chunk->current_size;
+            if constexpr (std::is_trivially_copyable_v<value_type>) {
+                std::memmove(static_cast<void*>(data + offset + 1), data + offset, (count - offset) * sizeof(value_type));
+            }
+            else if (offset < count) {
+                ConstructAt(data + count, std::move(data[count - 1]));
+                std::move_backward(data + offset, data + count - 1, data + count);
+                DestroyRange(data + offset, data + offset + 1);
+            }
+        }
+
+        void CloseGap(Chunk<value_type>* chunk, int offset, int count) noexcept {
+            value_type* data = chunk->data();
+            int current = chunk->current_size;
+            if constexpr (std::is_trivially_copyable_v<value_type>) {
+                std::memmove(static_cast<void*>(data + offset), data + offset + count,
+                             (current - offset - count) * sizeof(value_type));
+            }
+            else {
+                std::move(data + offset + count, data + current, data + offset);
+                DestroyRange(data + current - count, data + current);
+            }
+            chunk->current_size -= count;
+        }
+
+        Chunk<value_type>* Split(Chunk<value_type>* chunk, size_type number, int at) {
+            Chunk<value_type>* upper = LinkAfter(chunk, number + 1, chunk->size);
+            Relocate(upper->data(), chunk->data() + at, chunk->current_size - at);
+            upper->current_size = chunk->current_size - at;
+            chunk->current_size = at;
+            directory.Update(number);
+            return upper;
+        }
+
+        void MergeAround(Chunk<value_type>* chunk, size_type number) noexcept {
+            if (chunk->current_size == 0) {
+                if (chunk_count > 1) {
+                    Unlink(chunk, number);
+                }
+                return;
+            }
+            if (chunk->current_size >= chunk->size / 2) {
+                return;
+            }
+            Chunk<value_type>* left = chunk;
+            if (chunk->next != nullptr && chunk->current_size + chunk->next->current_size <= chunk->size) {
+                number++;
+            }
+            else if (chunk->prev != nullptr && chunk->current_size + chunk->prev->current_size <= chunk->prev->size) {
+                left = chunk->prev;
+            }
+            else {
+                return;
+            }
+            Chunk<value_type>* right = left->next;
+            if (maybe_shared && (IsShared(left) || IsShared(right))) {
+                return;
+            }
+            Rewind(left);
+            Relocate(left->data() + left->current_size, right->data(), right->current_size);
+            left->current_size += right->current_size;
+            right->current_size = 0;
+            Unlink(right, number);
+            directory.Update(number - 1);
+        }
+
+        template <typename... Args>
+        void ConstructAt(value_type* position, Args&&... args) {
+            allocator_traits::construct(own_pool.AllocatorRef(), position, std::forward<Args>(args)...);
+        }
+
+        void DestroyRange(value_type* first, value_type* last) noexcept {
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                for (; first != last; ++first) {
+                    allocator_traits::destroy(own_pool.AllocatorRef(), first);
+                }
+            }
+        }
+
+        void Rewind(Chunk<value_type>* chunk) noexcept {
+            if (chunk->begin_offset > 0) {
+                value_type* source = chunk->data();
+                chunk->begin_offset = 0;
+                Relocate(chunk->data(), source, chunk->current_size);
+            }
+        }
+
+        // The element count is an int, so a list holds at most INT_MAX
+        // elements; growing past max_size() throws before anything changes.
+        void CheckGrowth(size_type count) const {
+            if (count > max_size() - static_cast<size_type>(size)) {
+                throw std::length_error("chunk list exceeds max_size");
+            }
+        }
+
+        Chunk<value_type>* ReserveBack() {
+            CheckGrowth(1);
+            if (maybe_shared && tail != nullptr) {
+                MakeUnique(tail, chunk_count - 1);
+            }
+            if (tail != nullptr && tail->current_size == 0) {
+                tail->begin_offset = 0;
+            }
+            if (tail == nullptr || tail->GetFreeSlots() == 0) {
+                AppendChunk();
+            }
+            return tail;
+        }
+
+        void SlideToBack(Chunk<value_type>* chunk) noexcept {
+            int shift = chunk->GetFreeSlots();
+            value_type* data = chunk->data();
+            if constexpr (std::is_trivially_copyable_v<value_type>) {
+                std::memmove(static_cast<void*>(data + shift), data, chunk->current_size * sizeof(value_type));
+            }
+            else if (shift > 0) {
+                for (int i = chunk->current_size - 1; i >= 0; i--) {
+                    ConstructAt(data + shift + i, std::move(data[i]));
+                    DestroyRange(data + i, data + i + 1);
+                }
+            }
+            chunk->begin_offset += shift;
+        }
+
+        Chunk<value_type>* ReserveFront() {
+            CheckGrowth(1);
+            if (maybe_shared && start != nullptr) {
+                MakeUnique(start, 0);
+            }
+            if (start != nullptr && start->begin_offset == 0) {
+                SlideToBack(start);
+            }
+            if (start == nullptr || start->begin_offset == 0) {
+                Chunk<value_type>* chunk = LinkAfter(nullptr, 0, sizing.SizeOf(0));
+                chunk->begin_offset = chunk->size;
+            }
+            return start;
+        }
+
+        void DiscardEmptyHead() noexcept {
+            if (start != nullptr && start->current_size == 0) {
+                if (start != tail) {
+                    Unlink(start, 0);
+                }
+                else {
+                    start->begin_offset = 0;
+                }
+            }
+        }
+
+        void Compact() noexcept {
+            bool canonical = true;
+            size_type number = 0;
+            for (Chunk<value_type>* chunk = start; chunk != nullptr; chunk = chunk->next, number++) {
+                Rewind(chunk);
+                canonical = canonical && chunk->size == sizing.SizeOf(number);
+                while (chunk->current_size < chunk->size && chunk->next != nullptr) {
+                    Chunk<value_type>* next = chunk->next;
+                    int moved = std::min(chunk->size - chunk->current_size, next->current_size);
+                    Relocate(chunk->data() + chunk->current_size, next->data(), moved);
+                    Relocate(next->data(), next->data() + moved, next->current_size - moved);
+                    chunk->current_size += moved;
+                    next->current_size -= moved;
+                    if (next->current_size == 0) {
+                        Unlink(next, number + 1);
+                    }
+                }
+            }
+            directory.Invalidate(0);
+            uniform = canonical;
+        }
+
+        void DiscardEmptyTail() noexcept {
+            if (tail != nullptr && tail->current_size == 0 && tail != start) {
+                ReleaseTail();
+            }
+        }
+
+        void DropBack() {
+            if (maybe_shared) {
+                MakeUnique(tail, chunk_count - 1);
+            }
+            tail->current_size--;
+            size--;
+            DestroyRange(tail->data() + tail->current_size, tail->data() + tail->current_size + 1);
+            DiscardEmptyTail();
+        }
+
+        void DropFront() {
+            if (maybe_shared) {
+                MakeUnique(start, 0);
+            }
+            DestroyRange(start->data(), start->data() + 1);
+            start->begin_offset++;
+            start->current_size--;
+            size--;
+            directory.Update(0);
+            DiscardEmptyHead();
+        }
+
+        void AppendCopies(size_type count, const value_type& value) {
+            CheckGrowth(count);
+            while (count > 0) {
+                Chunk<value_type>* chunk = ReserveBack();
+                int free_slots = chunk->GetFreeSlots();
+                int filled = count < static_cast<size_type>(free_slots) ? static_cast<int>(count) : free_slots;
+                value_type* destination = chunk->data() + chunk->current_size;
+                if constexpr (std::is_trivially_copyable_v<value_type>) {
+                    std::uninitialized_fill_n(destination, filled, value);
+                    chunk->current_size += filled;
+                }
+                else {
+                    try {
+                        for (int i = 0; i < filled; i++, chunk->current_size++) {
+                            ConstructAt(destination + i, value);
+                        }
+                    }
+                    catch (...) {
+                        size += chunk->current_size - (destination - chunk->data());
+                        DiscardEmptyTail();
+                        throw;
+                    }
+                }
+                size += filled;
+                count -= filled;
+            }
+        }
+
+        template <typename InputIt>
+        InputIt CopyIntoChunk(Chunk<value_type>* chunk, InputIt source, int count) {
+            value_type* destination = chunk->data() + chunk->current_size;
+            if constexpr (std::contiguous_iterator<InputIt> && std::is_trivially_copyable_v<value_type> &&
+                          std::is_same_v<std::iter_value_t<InputIt>, value_type>) {
+                std::memcpy(static_cast<void*>(destination), std::to_address(source), count * sizeof(value_type));
+                chunk->current_size += count;
+                size += count;
+                return source + count;
+            }
+            else {
+                for (int i = 0; i < count; i++, ++source) {
+                    ConstructAt(destination + i, *source);
+                    chunk->current_size++;
+                    size++;
+                }
+                return source;
+            }
+        }
+
+        template <typename InputIt>
+        InputIt AppendCopy(InputIt source, size_type count) {
+            CheckGrowth(count);
+            while (count > 0) {
+                Chunk<value_type>* chunk = ReserveBack();
+                int free_slots = chunk->GetFreeSlots();
+                int copied = count < static_cast<size_type>(free_slots) ? static_cast<int>(count) : free_slots;
+                try {
+                    source = CopyIntoChunk(chunk, source, copied);
+                }
+                catch (...) {
+                    DiscardEmptyTail();
+                    throw;
+                }
+                count -= copied;
+            }
+            return source;
+        }
+
+        template <typename InputIt, typename Sentinel>
+        void AppendRange(InputIt first, Sentinel last) {
+            if constexpr (std::forward_iterator<InputIt> || std::sized_sentinel_for<Sentinel, InputIt>) {
+                size_type count = static_cast<size_type>(std::ranges::distance(first, last));
+                directory.reserve(chunk_count + count / sizing.SizeOf(chunk_count) + 1);
+                AppendCopy(first, count);
+            }
+            else {
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            }
+        }
+
+        template <typename InputIt, typename Sentinel>
+        iterator InsertRange(int index, InputIt first, Sentinel last) {
+            if (index < 0 || index > size) {
+                throw std::out_of_range("out of range");
+            }
+            if (index == size) {
+                AppendRange(first, last);
+                return MakeIterator(index, Unsharer());
+            }
+            if constexpr (!std::forward_iterator<InputIt> && !std::sized_sentinel_for<Sentinel, InputIt>) {
+                ChunkList buffer(get_allocator());
+                buffer.AppendRange(first, last);
+                return InsertRange(index, std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()));
+            }
+            else {
+                size_type count = static_cast<size_type>(std::ranges::distance(first, last));
+                if (count == 0) {
+                    return MakeIterator(index, Unsharer());
+                }
+                CheckGrowth(count);
+                uniform = false;
+                Location location = Locate(index);
+                directory.reserve(chunk_count + count / sizing.SizeOf(location.number) + 2);
+                if (maybe_shared && location.offset > 0) {
+                    location.chunk = MakeUnique(location.chunk, location.number);
+                }
+                Chunk<value_type>* previous = location.chunk->prev;
+                size_type number = location.number;
+                if (location.offset > 0) {
+                    Split(location.chunk, location.number, location.offset);
+                    previous = location.chunk;
+                    number++;
+                }
+                while (count > 0) {
+                    Chunk<value_type>* chunk = LinkAfter(previous, number, sizing.SizeOf(number));
+                    int copied = count < static_cast<size_type>(chunk->size) ? static_cast<int>(count) : chunk->size;
+                    try {
+                        first = CopyIntoChunk(chunk, first, copied);
+                    }
+                    catch (...) {
+                        if (chunk->current_size == 0) {
+                            Unlink(chunk, number);
+                        }
+                        throw;
+                    }
+                    count -= copied;
+                    previous = chunk;
+                    number++;
+                }
+                MergeAround(previous, number - 1);
+                if (location.offset > 0) {
+                    MergeAround(location.chunk, location.number);
+                }
+                return MakeIterator(index, Unsharer());
+            }
+        }
+
+        iterator MakeIterator(int index, ChunkUnsharer<value_type> unsharer = {}) const {
+            if (index == size) {
+                return ChunkList_iterator<value_type>(tail, tail == nullptr ? nullptr : tail->data() + tail->current_size,
+                                                      size, unsharer);
+            }
+            Location location = Locate(index);
+            return ChunkList_iterator<value_type>(location.chunk, location.chunk->data() + location.offset, index, unsharer);
+        }
+
+        void SwapChains(ChunkList& other) noexcept {
+            std::swap(start, other.start);
+            std::swap(tail, other.tail);
+            std::swap(size, other.size);
+            std::swap(chunk_count, other.chunk_count);
+            std::swap(sizing, other.sizing);
+            std::swap(uniform, other.uniform);
+            std::swap(maybe_shared, other.maybe_shared);
+            directory.swap(other.directory);
+            if constexpr (InlineFirst) {
+                SwapInline(other);
+            }
+        }
+
+        // After the chains are swapped each list holds the other's inline
+        // block. Swapping the blocks' contents gives every list its own block
+        // back in the same place in its new chain.
+        void SwapInline(ChunkList& other) noexcept {
+            Chunk<value_type>* mine = reinterpret_cast<Chunk<value_type>*>(inline_block.bytes);
+            Chunk<value_type>* theirs = reinterpret_cast<Chunk<value_type>*>(other.inline_block.bytes);
+            if (!inline_block.used && !other.inline_block.used) {
+                return;
+            }
+            if (!inline_block.used) {
+                ::new (static_cast<void*>(mine)) Chunk<value_type>(N);
+            }
+            if (!other.inline_block.used) {
+                ::new (static_cast<void*>(theirs)) Chunk<value_type>(N);
+            }
+            value_type* first = mine->storage();
+            value_type* second = theirs->storage();
+            int first_end = mine->begin_offset + mine->current_size;
+            int second_end = theirs->begin_offset + theirs->current_size;
+            for (int i = std::min(mine->begin_offset, theirs->begin_offset); i < std::max(first_end, second_end); i++) {
+                bool in_first = i >= mine->begin_offset && i < first_end;
+                bool in_second = i >= theirs->begin_offset && i < second_end;
+                if (in_first && in_second) {
+                    value_type temporary(std::move(first[i]));
+                    DestroyRange(first + i, first + i + 1);
+                    Relocate(first + i, second + i, 1);
+                    ConstructAt(second + i, std::move(temporary));
+                }
+                else if (in_first) {
+                    Relocate(second + i, first + i, 1);
+                }
+                else if (in_second) {
+                    Relocate(first + i, second + i, 1);
+                }
+            }
+            std::swap(mine->begin_offset, theirs->begin_offset);
+            std::swap(mine->current_size, theirs->current_size);
+            std::swap(mine->prev, theirs->prev);
+            std::swap(mine->next, theirs->next);
+            std::swap(inline_block.used, other.inline_block.used);
+            if (inline_block.used) {
+                Relink(mine);
+            }
+            if (other.inline_block.used) {
+                other.Relink(theirs);
+            }
+        }
+
+        void Relink(Chunk<value_type>* chunk) noexcept {
+            if (chunk->prev != nullptr) {
+                chunk->prev->next = chunk;
+            }
+            else {
+                start = chunk;
+            }
+            if (chunk->next != nullptr) {
+                chunk->next->prev = chunk;
+            }
+            else {
+                tail = chunk;
+            }
+            if constexpr (Indexed) {
+                size_type number = 0;
+                for (Chunk<value_type>* current = start; current != chunk; current = current->next) {
+                    number++;
+                }
+                directory.Replace(number, chunk);
+            }
+        }
+
+        void SwapAllocators(ChunkList& other) noexcept {
+            own_pool.swap(other.own_pool);
+            directory.SwapAllocator(other.directory);
+        }
+
+        void MoveElementsFrom(ChunkList& other) {
+            other.Unshare();
+            for (Chunk<value_type>* other_list = other.start; other_list != nullptr; other_list = other_list->next) {
+                for (int j = 0; j < other_list->current_size; j++) {
+                    emplace_back(std::move(other_list->data()[j]));
+                }
+            }
+            other.clear();
+        }
+
+        template <typename... Args>
+        iterator EmplaceAt(int index, Args&&... args) {
+            if (index < 0 || index > size) {
+                throw std::out_of_range("out of range");
+            }
+            if (index == size) {
+                emplace_back(std::forward<Args>(args)...);
+                return MakeIterator(index, Unsharer());
+            }
+            CheckGrowth(1);
+            value_type value(std::forward<Args>(args)...);
+            Location location = Locate(index);
+            if (maybe_shared) {
+                location.chunk = MakeUnique(location.chunk, location.number);
+            }
+            if (location.chunk != tail) {
+                uniform = false;
+            }
+            if (location.chunk->GetFreeSlots() == 0 && location.chunk->begin_offset > 0) {
+                Rewind(location.chunk);
+            }
+            if (location.chunk->GetFreeSlots() == 0) {
+                if (location.chunk == tail) {
+                    Chunk<value_type>* spill = AppendChunk();
+                    Relocate(spill->data(), tail->prev->data() + tail->prev->current_size - 1, 1);
+                    spill->current_size = 1;
+                    tail->prev->current_size--;
+                }
+                else {
+                    Chunk<value_type>* upper = Split(location.chunk, location.number, location.chunk->current_size / 2);
+                    if (location.offset > location.chunk->current_size) {
+                        location.offset -= location.chunk->current_size;
+                        location.chunk = upper;
+                        location.number++;
+                    }
+                }
+            }
+            OpenGap(location.chunk, location.offset);
+            ConstructAt(location.chunk->data() + location.offset, std::move(value));
+            location.chunk->current_size++;
+            size++;
+            directory.Update(location.number);
+            return ChunkList_iterator<value_type>(location.chunk, location.chunk->data() + location.offset, index,
+                                                  Unsharer());
+        }
+
+        // Trims the chunk the range starts in, unlinks the whole chunks after
+        // it as one run and trims the chunk it ends in, so the chain is walked
+        // once and the directory shifted once however many chunks go.
+        void EraseAt(int index, int count) {
+            if (count == 0) {
+                return;
+            }
+            Location location = Locate(index);
+            Chunk<value_type>* chunk = location.chunk;
+            size_type number = location.number;
+            Chunk<value_type>* last = nullptr;
+            size_type last_number = 0;
+            if (location.offset > 0 || count < chunk->current_size) {
+                if (maybe_shared) {
+                    chunk = MakeUnique(chunk, number);
+                }
+                if (chunk != tail) {
+                    uniform = false;
+                }
+                int removed = std::min(count, chunk->current_size - location.offset);
+                CloseGap(chunk, location.offset, removed);
+                size -= removed;
+                count -= removed;
+                directory.Update(number);
+                last = chunk;
+                last_number = number;
+                chunk = chunk->next;
+                number++;
+            }
+            Chunk<value_type>* first = chunk;
+            size_type run = 0;
+            while (count > 0 && count >= chunk->current_size && run + 1 < chunk_count) {
+                size -= chunk->current_size;
+                count -= chunk->current_size;
+                chunk = chunk->next;
+                run++;
+            }
+            if (run > 0) {
+                Chunk<value_type>* before = first->prev;
+                if (before != nullptr) {
+                    before->next = chunk;
+                }
+                else {
+                    start = chunk;
+                }
+                if (chunk != nullptr) {
+                    chunk->prev = before;
+                    uniform = false;
+                }
+                else {
+                    tail = before;
+                }
+                directory.erase(number, run);
+                chunk_count -= run;
+                for (size_type i = 0; i < run; i++) {
+                    Chunk<value_type>* next = first->next;
+                    DropChunk(first);
+                    first = next;
+                }
             }
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
+            if (count > 0) {
+                if (maybe_shared) {
+                    chunk = MakeUnique(chunk, number);
+                }
+                if (chunk != tail) {
+                    uniform = false;
+                }
+                CloseGap(chunk, 0, count);
+                size -= count;
+                directory.Update(number);
+                last = chunk;
+                last_number = number;
             }
-            if (temp_pointer->current_size == temp_pointer->size) {
-                temp_pointer->next = new Chunk<value_type>(N);
-                Chunk<value_type>* prev_pointer = temp_pointer;
-                temp_pointer = temp_pointer->next;
-                temp_pointer->prev = prev_pointer;
+            if (last != nullptr) {
+                MergeAround(last, last_number);
             }
-            temp_pointer->list[temp_pointer->current_size] = std::move(value);
-            temp_pointer->current_size++;
-            size++;
         }
 
-        void pop_back() {
-            if (start == nullptr) {
+    public:
+
+        ChunkList() : ChunkList(Allocator()) {}
+
+        explicit ChunkList(const Allocator& alloc) : ChunkList(sizing_type(), alloc) {}
+
+        explicit ChunkList(const sizing_type& chunk_sizing, const Allocator& alloc = Allocator()) :
+                sizing(chunk_sizing), directory(alloc), own_pool(pool_type::default_high_water_mark, alloc) {}
+
+        size_t GetSize() const noexcept override {
+            return size;
+        }
+
+        ChunkList(size_type count, const T& value = T(), const Allocator& alloc = Allocator()) : ChunkList(alloc)
+        {
+            AppendCopies(count, value);
+        }
+
+        explicit ChunkList(size_type count, const Allocator& alloc = Allocator()) : ChunkList(alloc)
+        {
+            for (size_type i = 0; i < count; i++) {
+                emplace_back();
+            }
+        }
+
+        template <std::input_iterator InputIt>
+        ChunkList(InputIt first, InputIt last, const Allocator& alloc = Allocator()) : ChunkList(alloc) {
+            AppendRange(first, last);
+        }
+
+        ChunkList(std::initializer_list<T> init, const Allocator& alloc = Allocator()) : ChunkList(alloc) {
+            AppendRange(init.begin(), init.end());
+        }
+
+#ifdef __cpp_lib_containers_ranges
+        template <std::ranges::input_range R>
+        ChunkList(std::from_range_t, R&& range, const Allocator& alloc = Allocator()) : ChunkList(alloc) {
+            AppendRange(std::ranges::begin(range), std::ranges::end(range));
+        }
+#endif
+
+        ChunkList(const ChunkList& other) :
+                ChunkList(other, allocator_traits::select_on_container_copy_construction(other.get_allocator())) {}
+
+        ChunkList(const ChunkList& other, const Allocator& alloc) : ChunkList(other.sizing, alloc) {
+            if (other.size > 0 && get_allocator() == other.get_allocator()) {
+                ShareChunks(other);
+                return;
+            }
+            for (Chunk<value_type>* other_list = other.start; other_list != nullptr; other_list = other_list->next) {
+                AppendCopy(other_list->data(), other_list->current_size);
+            }
+        }
+
+        ChunkList(ChunkList&& other) noexcept :
+                sizing(other.sizing), directory(other.get_allocator()),
+                own_pool(pool_type::default_high_water_mark, other.get_allocator()), shared_pool(other.shared_pool) {
+            SwapChains(other);
+        }
+
+        ChunkList(ChunkList&& other, const Allocator& alloc) :
+                sizing(other.sizing), directory(alloc), own_pool(pool_type::default_high_water_mark, alloc) {
+            if (alloc == other.get_allocator()) {
+                SwapChains(other);
+            }
+            else {
+                MoveElementsFrom(other);
+            }
+        }
+
+        ~ChunkList() {
+            clear();
+        }
+
+        ChunkList& operator=(const ChunkList& other) {
+            if (this != &other) {
+                if constexpr (allocator_traits::propagate_on_container_copy_assignment::value) {
+                    ChunkList copy(other, other.get_allocator());
+                    clear();
+                    SwapChains(copy);
+                    SwapAllocators(copy);
+                }
+                else {
+                    ChunkList copy(other, get_allocator());
+                    SwapChains(copy);
+                }
+            }
+            return *this;
+        }
+
+        ChunkList& operator=(ChunkList&& other) noexcept(allocator_traits::propagate_on_container_move_assignment::value ||
+                                                       allocator_traits::is_always_equal::value) {
+            if (this != &other) {
+                clear();
+                if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+                    SwapChains(other);
+                    SwapAllocators(other);
+                }
+                else if (get_allocator() == other.get_allocator()) {
+                    SwapChains(other);
+                }
+                else {
+                    MoveElementsFrom(other);
+                }
+            }
+            return *this;
+        }
+
+        void assign(size_type count, const T& value) {
+            if (count > 0) {
+                clear();
+                AppendCopies(count, value);
+            }
+        }
+
+        template <std::input_iterator InputIt>
+        void assign(InputIt first, InputIt last) {
+            clear();
+            AppendRange(first, last);
+        }
+
+        void assign(std::initializer_list<T> init) {
+            clear();
+            AppendRange(init.begin(), init.end());
+        }
+
+        template <std::ranges::input_range R>
+        void assign_range(R&& range) {
+            clear();
+            AppendRange(std::ranges::begin(range), std::ranges::end(range));
+        }
+
+        allocator_type get_allocator() const noexcept {
+            return own_pool.get_allocator();
+        }
+
+        reference at(size_type pos) override {
+            if (pos >= static_cast<size_type>(size)) {
+                throw std::out_of_range("out of range");
+            }
+            Location location = Locate(pos);
+            if (maybe_shared) {
+                location.chunk = MakeUnique(location.chunk, location.number);
+            }
+            return location.chunk->data()[location.offset];
+        }
+
+        const_reference at(size_type pos) const
+        {
+            if (pos >= static_cast<size_type>(size)) {
+                throw std::out_of_range("out of range");
+            }
+            Location location = Locate(pos);
+            return location.chunk->data()[location.offset];
+        }
+
+        reference operator[](difference_type pos) override {
+            Location location = Locate(pos);
+            if (maybe_shared) {
+                location.chunk = MakeUnique(location.chunk, location.number);
+            }
+            return location.chunk->data()[location.offset];
+        }
+
+        const_reference operator[](difference_type pos) const
+        {
+            Location location = Locate(pos);
+            return location.chunk->data()[location.offset];
+        }
+
+        reference front() {
+            if (size == 0) {
+                throw std::runtime_error("empty");
+            }
+            if (maybe_shared) {
+                MakeUnique(start, 0);
+            }
+            return start->data()[0];
+        }
+
+        const_reference front() const {
+            if (size > 0)
+                return start->data()[0];
+            else
+                throw std::runtime_error("empty");
+        }
+
+        reference back() {
+            if (size == 0) {
+                throw std::runtime_error("empty");
+            }
+            if (maybe_shared) {
+                MakeUnique(tail, chunk_count - 1);
+            }
+            return tail->data()[tail->current_size - 1];
+        }
+
+        const_reference back() const {
+            if (size == 0) {
                 throw std::runtime_error("empty");
+            }
+            return tail->data()[tail->current_size - 1];
+        }
+
+        iterator begin() {
+            return MakeIterator(0, Unsharer());
+        }
+
+        const_iterator begin() const noexcept {
+            return MakeIterator(0);
+        }
+
+        const_iterator cbegin() const noexcept {
+            return begin();
+        }
+
+        iterator end() {
+            return MakeIterator(size, Unsharer());
+        }
+
+        const_iterator end() const noexcept {
+            return MakeIterator(size);
+        }
+
+        const_iterator cend() const noexcept {
+            return end();
+        }
+
+        // The iterator at position, located through the directory rather than
+        // by stepping from begin(), so it clones no chunk on the way.
+        iterator nth(size_type position) {
+            if (position > static_cast<size_type>(size)) {
+                throw std::out_of_range("out of range");
+            }
+            return MakeIterator(static_cast<int>(position), Unsharer());
+        }
+
+        const_iterator nth(size_type position) const {
+            if (position > static_cast<size_type>(size)) {
+                throw std::out_of_range("out of range");
+            }
+            return MakeIterator(static_cast<int>(position));
+        }
+
+        pool_type& get_chunk_pool() noexcept {
+            return Pool();
+        }
+
+        void set_chunk_pool(pool_type* pool) noexcept {
+            shared_pool = pool;
+        }
+
+        ChunkList_segments<value_type> segments() {
+            if (maybe_shared && start != nullptr) {
+                start = MakeUnique(start, 0);
+            }
+            return ChunkList_segments<value_type>(start, Unsharer());
+        }
+
+        ChunkList_segments<const value_type> segments() const noexcept {
+            return ChunkList_segments<const value_type>(start);
+        }
+
+        bool empty() const noexcept {
+            return size == 0;
+        }
+
+        int get_size() const noexcept {
+            return size;
+        }
+
+        size_type get_chunk_count() const noexcept {
+            return chunk_count;
+        }
+
+        const sizing_type& get_chunk_sizing() const noexcept {
+            return sizing;
+        }
+
+        size_type max_size() const noexcept {
+            return std::min<size_type>(std::numeric_limits<int>::max(),
+                                       allocator_traits::max_size(own_pool.get_allocator()));
+        }
+
+        // Counts only the chunks the list's own pool holds in the sizes its
+        // next appends will ask for. A shared pool is left out: other lists
+        // can take its chunks, so reserve() sets chunks aside in the own pool,
+        // which AcquireChunk tries first.
+        size_type capacity() const noexcept {
+            size_type free_slots = tail == nullptr ? 0 : tail->GetFreeSlots();
+            if constexpr (InlineFirst) {
+                free_slots += inline_block.used ? 0 : N;
+            }
+            size_type reserved = ReservedChunks();
+            for (size_type number = 0; number < reserved; number++) {
+                free_slots += sizing.SizeOf(chunk_count + number);
+            }
+            return size + free_slots;
+        }
+
+        void reserve(size_type new_capacity) {
+            if (new_capacity > max_size()) {
+                throw std::length_error("reserve exceeds max_size");
+            }
+            size_type current = capacity();
+            if (new_capacity <= current) {
                 return;
             }
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
+            size_type reserved = ReservedChunks();
+            size_type chunks = 0;
+            for (size_type slots = current; slots < new_capacity; chunks++) {
+                slots += sizing.SizeOf(chunk_count + reserved + chunks);
             }
-            temp_pointer->current_size--;
-            size--;
+            directory.reserve(chunk_count + reserved + chunks);
+            own_pool.Reserve(reserved, chunks, [&](size_type number) {
+                return sizing.SizeOf(chunk_count + reserved + number);
+            });
         }
 
-        void push_front(const T& value) {
-            insert(cbegin(), value);
+        // Compacting chunks that a copy still holds would clone them, so a
+        // list that shares chunks is left as it is.
+        void shrink_to_fit() noexcept {
+            if (SharesChunks()) {
+                return;
+            }
+            Compact();
+            own_pool.Trim(0);
         }
 
-        void push_front(T&& value) {
-            insert(cbegin(), std::move(value));
+        void clear() noexcept {
+            while (tail != nullptr) {
+                ReleaseTail();
+            }
+            size = 0;
+            uniform = true;
         }
 
-        void pop_front() {
-            erase(cbegin());
+        iterator insert(const_iterator pos, const T& value) {
+            return EmplaceAt(pos.GetIndex(), value);
         }
 
-        void swap(ChunkList& other) {
-            Chunk<value_type>* tmp_start;
-            int tmp_size;
-            tmp_start = other.start;
-            tmp_size = other.size;
-            other.start = this->start;
-            other.size = this->size;
-            this->start = tmp_start;
-            this->size = tmp_size;
+        iterator insert(const_iterator pos, T&& value) {
+            return EmplaceAt(pos.GetIndex(), std::move(value));
         }
 
-        template <class U, class Alloc>
-        friend bool operator==(const ChunkList<U, N, Alloc>& lhs,
-                               const ChunkList<U, N, Alloc>& rhs) {
-            if (lhs.size != rhs.size) {
-                return false;
+        template <std::input_iterator InputIt>
+        iterator insert(const_iterator pos, InputIt first, InputIt last) {
+            return InsertRange(pos.GetIndex(), first, last);
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> init) {
+            return InsertRange(pos.GetIndex(), init.begin(), init.end());
+        }
+
+        template <std::ranges::input_range R>
+        iterator insert_range(const_iterator pos, R&& range) {
+            return InsertRange(pos.GetIndex(), std::ranges::begin(range), std::ranges::end(range));
+        }
+
+        template <std::ranges::input_range R>
+        void append_range(R&& range) {
+            AppendRange(std::ranges::begin(range), std::ranges::end(range));
+        }
+
+        template <typename... Args>
+        iterator emplace(const_iterator pos, Args&&... args) {
+            return EmplaceAt(pos.GetIndex(), std::forward<Args>(args)...);
+        }
+
+        iterator erase(const_iterator pos) {
+            int index = pos.GetIndex();
+            if (index < 0 || index >= size) {
+                throw std::out_of_range("out of range");
             }
-            for (int i = 0; i < lhs.size; i++) {
-                if (lhs.at(i) != rhs.at(i)) {
-                    return false;
-                }
+            EraseAt(index, 1);
+            return MakeIterator(index, Unsharer());
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            int index = first.GetIndex();
+            int range_length = last.GetIndex() - index;
+            if (range_length <= 0) {
+                return MakeIterator(index, Unsharer());
             }
+            EraseAt(index, range_length);
+            return MakeIterator(index, Unsharer());
+        }
 
-            return true;
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            Chunk<value_type>* chunk = ReserveBack();
+            try {
+                ConstructAt(chunk->data() + chunk->current_size, std::forward<Args>(args)...);
+            }
+            catch (...) {
+                DiscardEmptyTail();
+                throw;
+            }
+            chunk->current_size++;
+            size++;
+            return chunk->data()[chunk->current_size - 1];
+        }
+
+        template <typename... Args>
+        reference emplace_front(Args&&... args) {
+            Chunk<value_type>* chunk = ReserveFront();
+            try {
+                ConstructAt(chunk->data() - 1, std::forward<Args>(args)...);
+            }
+            catch (...) {
+                DiscardEmptyHead();
+                throw;
+            }
+            chunk->begin_offset--;
+            chunk->current_size++;
+            size++;
+            directory.Update(0);
+            return chunk->data()[0];
+        }
+
+        void push_back(const T& value) {
+            emplace_back(value);
         }
 
-        template <class U, class Alloc>
-        friend bool operator!=(const ChunkList<U, N, Alloc>& lhs,
-                               const ChunkList<U, N, Alloc>& rhs) {
+        void push_back(T&& value) {
+            emplace_back(std::move(value));
+        }
+
+        void pop_back() {
+            if (size == 0) {
+                throw std::runtime_error("empty");
+            }
+            DropBack();
+        }
+
+        void push_front(const T& value) {
+            emplace_front(value);
+        }
+
+        void push_front(T&& value) {
+            emplace_front(std::move(value));
+        }
+
+        void pop_front() {
+            if (size == 0) {
+                throw std::runtime_error("empty");
+            }
+            DropFront();
+        }
+
+        void swap(ChunkList& other) noexcept {
+            SwapChains(other);
+            if constexpr (allocator_traits::propagate_on_container_swap::value) {
+                SwapAllocators(other);
+            }
+        }
+
+        friend bool operator==(const ChunkList& lhs, const ChunkList& rhs) {
+            return fefu_laboratory_two::equal(lhs, rhs);
+        }
+
+        friend bool operator!=(const ChunkList& lhs, const ChunkList& rhs) {
             return !(lhs == rhs);
         }
     };
-}
\ No newline at end of file
+
+    template <std::size_t Bytes>
+    class ChunkArena : public std::pmr::monotonic_buffer_resource {
+    public:
+        explicit ChunkArena(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+                std::pmr::monotonic_buffer_resource(buffer, Bytes, upstream) {}
+
+    private:
+        alignas(std::max_align_t) std::byte buffer[Bytes];
+    };
+
+    namespace pmr {
+        template <typename T, int N, bool Indexed = true>
+        using ChunkList = fefu_laboratory_two::ChunkList<T, N, std::pmr::polymorphic_allocator<T>, Indexed>;
+    }
+}
@@ -0,0 +1,206 @@
+#pragma once
+#include "ChunkList.hpp"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fefu_laboratory_two {
+    // Bounded multi-producer multi-consumer queue over a ring of chunks. The
+    // chunks sit in a vector whose size is a power of two, and position p
+    // lives in chunk (p / N) & mask, so the chunk a consumer drains at the
+    // head is the one producers fill next once they wrap around the tail.
+    // Every slot carries a sequence number: a producer may fill position p
+    // when the slot reads p, a consumer may take it when it reads p + 1, and
+    // a consumer hands it back for the next lap as p + capacity.
+    template <typename T, int N = 64, typename Allocator = Allocator<T>>
+    class ChunkQueue {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using allocator_type = Allocator;
+
+        explicit ChunkQueue(size_type capacity, const Allocator& alloc = Allocator()) :
+                pool(0, cell_allocator(alloc)),
+                mask(std::bit_ceil(std::max<size_type>(1, (capacity + N - 1) / N)) - 1) {
+            chunks.reserve(mask + 1);
+            try {
+                for (size_type number = 0; number <= mask; number++) {
+                    Chunk<Cell>* chunk = pool.Acquire(N);
+                    for (int i = 0; i < N; i++) {
+                        ::new (static_cast<void*>(chunk->data() + i)) Cell(number * N + i);
+                    }
+                    chunk->current_size = N;
+                    chunks.push_back(chunk);
+                }
+            }
+            catch (...) {
+                ReleaseChunks();
+                throw;
+            }
+        }
+
+        ChunkQueue(const ChunkQueue& other) = delete;
+
+        ChunkQueue& operator=(const ChunkQueue& other) = delete;
+
+        ~ChunkQueue() {
+            while (try_pop()) {
+            }
+            ReleaseChunks();
+        }
+
+        size_type capacity() const noexcept {
+            return chunks.size() * N;
+        }
+
+        // Snapshot only: other threads may change it before the caller looks.
+        size_type size_approx() const noexcept {
+            size_type tail = enqueue_position.load(std::memory_order_relaxed);
+            size_type head = dequeue_position.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+        template <typename... Args>
+        bool try_emplace(Args&&... args) {
+            size_type position = enqueue_position.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (true) {
+                cell = At(position);
+                size_type sequence = cell->sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+                if (difference == 0) {
+                    if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (difference < 0) {
+                    return false;
+                }
+                else {
+                    position = enqueue_position.load(std::memory_order_relaxed);
+                }
+            }
+            try {
+                ::new (static_cast<void*>(cell->Value())) value_type(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                // The slot is ours already; hand it to consumers as a hole so
+                // the ring keeps moving.
+                cell->empty = true;
+                cell->sequence.store(position + 1, std::memory_order_release);
+                throw;
+            }
+            cell->empty = false;
+            cell->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_push(const value_type& value) {
+            return try_emplace(value);
+        }
+
+        bool try_push(value_type&& value) {
+            return try_emplace(std::move(value));
+        }
+
+        std::optional<value_type> try_pop() {
+            size_type position = dequeue_position.load(std::memory_order_relaxed);
+            while (true) {
+                Cell* cell = At(position);
+                size_type sequence = cell->sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+                if (difference == 0) {
+                    if (dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        std::optional<value_type> result;
+                        if (!cell->empty) {
+                            try {
+                                result.emplace(std::move(*cell->Value()));
+                            }
+                            catch (...) {
+                                // The slot is ours already; drop the element
+                                // and hand the slot back so the ring keeps moving.
+                                cell->Value()->~value_type();
+                                cell->sequence.store(position + capacity(), std::memory_order_release);
+                                throw;
+                            }
+                            cell->Value()->~value_type();
+                        }
+                        cell->sequence.store(position + capacity(), std::memory_order_release);
+                        if (result) {
+                            return result;
+                        }
+                        position = dequeue_position.load(std::memory_order_relaxed);
+                    }
+                }
+                else if (difference < 0) {
+                    return std::nullopt;
+                }
+                else {
+                    position = dequeue_position.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void push(const value_type& value) {
+            while (!try_push(value)) {
+                std::this_thread::yield();
+            }
+        }
+
+        void push(value_type&& value) {
+            while (!try_push(std::move(value))) {
+                std::this_thread::yield();
+            }
+        }
+
+        value_type pop() {
+            while (true) {
+                std::optional<value_type> value = try_pop();
+                if (value) {
+                    return std::move(*value);
+                }
+                std::this_thread::yield();
+            }
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_type> sequence;
+            bool empty = true;
+            alignas(value_type) unsigned char storage[sizeof(value_type)];
+
+            explicit Cell(size_type position) noexcept : sequence(position) {}
+
+            value_type* Value() noexcept {
+                return std::launder(reinterpret_cast<value_type*>(storage));
+            }
+        };
+
+        using cell_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Cell>;
+
+        ChunkPool<Cell, cell_allocator> pool;
+        std::vector<Chunk<Cell>*> chunks;
+        size_type mask;
+        alignas(64) std::atomic<size_type> enqueue_position = 0;
+        alignas(64) std::atomic<size_type> dequeue_position = 0;
+
+        Cell* At(size_type position) noexcept {
+            return chunks[(position / N) & mask]->data() + position % N;
+        }
+
+        void ReleaseChunks() noexcept {
+            for (Chunk<Cell>* chunk : chunks) {
+                for (int i = 0; i < chunk->current_size; i++) {
+                    chunk->data()[i].~Cell();
+                }
+                pool.Release(chunk);
+            }
+            chunks.clear();
+        }
+    };
+}
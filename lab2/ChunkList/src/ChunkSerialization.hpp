@@ -0,0 +1,245 @@
+#pragma once
+#include "ChunkList.hpp"
+#include <bit>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace fefu_laboratory_two {
+    // Binary image of a list of trivially copyable elements: a header, the
+    // live elements of every chunk back to back, and, when the header asks
+    // for it, a checksum of those bytes. Everything is in the byte order of
+    // the writing machine. The payload carries no chunk boundaries, so a list
+    // with a different N can read it.
+    struct BinaryHeader {
+        std::uint32_t magic;
+        std::uint16_t version;
+        std::uint16_t flags;
+        std::int32_t chunk_size;
+        std::uint32_t element_size;
+        std::uint64_t count;
+    };
+
+    inline constexpr std::uint32_t binary_magic = 0x4C434646;
+    inline constexpr std::uint16_t binary_version = 1;
+    inline constexpr std::uint16_t binary_checksum = 1;
+
+    // 64-bit hash built from xxHash64 rounds over four independent lanes, so
+    // it keeps up with the page cache.
+    class Checksum {
+    public:
+        void Update(const void* data, std::size_t bytes) noexcept {
+            const auto* input = static_cast<const std::byte*>(data);
+            length += bytes;
+            if (buffered > 0) {
+                std::size_t taken = std::min(bytes, sizeof(buffer) - buffered);
+                std::memcpy(buffer + buffered, input, taken);
+                buffered += taken;
+                input += taken;
+                bytes -= taken;
+                if (buffered < sizeof(buffer)) {
+                    return;
+                }
+                Stripe(buffer);
+                buffered = 0;
+            }
+            for (; bytes >= sizeof(buffer); input += sizeof(buffer), bytes -= sizeof(buffer)) {
+                Stripe(input);
+            }
+            std::memcpy(buffer, input, bytes);
+            buffered = bytes;
+        }
+
+        std::uint64_t Digest() const noexcept {
+            std::uint64_t result = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) +
+                                   std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+            result ^= length;
+            for (std::size_t i = 0; i < buffered; i++) {
+                result = std::rotl(result ^ std::to_integer<std::uint64_t>(buffer[i]) * prime2, 11) * prime1;
+            }
+            result ^= result >> 33;
+            result *= prime2;
+            result ^= result >> 29;
+            return result;
+        }
+
+    private:
+        static constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ull;
+        static constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+
+        std::uint64_t lanes[4] = {prime1 + prime2, prime2, 0, 0 - prime1};
+        std::byte buffer[32];
+        std::size_t buffered = 0;
+        std::uint64_t length = 0;
+
+        void Stripe(const std::byte* input) noexcept {
+            for (int i = 0; i < 4; i++) {
+                std::uint64_t word;
+                std::memcpy(&word, input + i * 8, 8);
+                lanes[i] = std::rotl(lanes[i] + word * prime2, 31) * prime1;
+            }
+        }
+    };
+
+    namespace detail {
+#ifdef IOV_MAX
+        inline constexpr std::size_t binary_batch = IOV_MAX < 1024 ? IOV_MAX : 1024;
+#else
+        inline constexpr std::size_t binary_batch = 16;
+#endif
+
+        // Advances past the first done bytes of a vector, dropping finished
+        // entries; returns the first entry that still has bytes.
+        inline std::size_t Consume(std::span<iovec> vectors, std::size_t first, std::size_t done) noexcept {
+            while (first < vectors.size() && done >= vectors[first].iov_len) {
+                done -= vectors[first].iov_len;
+                first++;
+            }
+            if (done > 0) {
+                vectors[first].iov_base = static_cast<std::byte*>(vectors[first].iov_base) + done;
+                vectors[first].iov_len -= done;
+            }
+            return first;
+        }
+
+        inline void WriteAll(int fd, std::span<iovec> vectors) {
+            std::size_t first = Consume(vectors, 0, 0);
+            while (first < vectors.size()) {
+                int count = static_cast<int>(std::min(vectors.size() - first, binary_batch));
+                ssize_t written = ::writev(fd, vectors.data() + first, count);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "writev");
+                }
+                first = Consume(vectors, first, static_cast<std::size_t>(written));
+            }
+        }
+
+        inline void ReadAll(int fd, std::span<iovec> vectors) {
+            std::size_t first = Consume(vectors, 0, 0);
+            while (first < vectors.size()) {
+                int count = static_cast<int>(std::min(vectors.size() - first, binary_batch));
+                ssize_t received = ::readv(fd, vectors.data() + first, count);
+                if (received < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "readv");
+                }
+                if (received == 0) {
+                    throw std::runtime_error("truncated chunk list");
+                }
+                first = Consume(vectors, first, static_cast<std::size_t>(received));
+            }
+        }
+    }
+
+    struct BinaryAccess {
+        template <typename T, int N, typename Allocator, bool Indexed, bool InlineFirst>
+        static void Read(int fd, ChunkList<T, N, Allocator, Indexed, InlineFirst>& list) {
+            BinaryHeader header;
+            iovec header_vector{&header, sizeof(header)};
+            detail::ReadAll(fd, std::span(&header_vector, 1));
+            if (header.magic != binary_magic || header.version != binary_version) {
+                throw std::runtime_error("not a chunk list image");
+            }
+            if (header.element_size != sizeof(T)) {
+                throw std::runtime_error("element size mismatch");
+            }
+            if (header.count > list.max_size()) {
+                throw std::length_error("chunk list image exceeds max_size");
+            }
+            list.clear();
+            try {
+                Checksum checksum;
+                std::vector<iovec> batch;
+                std::vector<iovec> pending;
+                std::vector<Chunk<T>*> chunks;
+                std::uint64_t remaining = header.count;
+                while (remaining > 0) {
+                    batch.clear();
+                    chunks.clear();
+                    while (remaining > 0 && batch.size() < detail::binary_batch) {
+                        Chunk<T>* chunk = chunks.empty() ? list.ReserveBack() : list.AppendChunk();
+                        int taken = static_cast<int>(std::min<std::uint64_t>(remaining, chunk->GetFreeSlots()));
+                        batch.push_back({chunk->data() + chunk->current_size, taken * sizeof(T)});
+                        chunks.push_back(chunk);
+                        remaining -= taken;
+                    }
+                    pending = batch;
+                    detail::ReadAll(fd, pending);
+                    for (std::size_t i = 0; i < chunks.size(); i++) {
+                        int taken = static_cast<int>(batch[i].iov_len / sizeof(T));
+                        chunks[i]->current_size += taken;
+                        list.size += taken;
+                        if (header.flags & binary_checksum) {
+                            checksum.Update(batch[i].iov_base, batch[i].iov_len);
+                        }
+                    }
+                }
+                if (header.flags & binary_checksum) {
+                    std::uint64_t digest;
+                    iovec digest_vector{&digest, sizeof(digest)};
+                    detail::ReadAll(fd, std::span(&digest_vector, 1));
+                    if (digest != checksum.Digest()) {
+                        throw std::runtime_error("checksum mismatch");
+                    }
+                }
+            }
+            catch (...) {
+                list.clear();
+                throw;
+            }
+        }
+    };
+
+    // Writes the image of list to fd with one writev per batch of chunks,
+    // straight from the chunk buffers.
+    template <typename T, int N, typename Allocator, bool Indexed, bool InlineFirst>
+    void write_binary(int fd, const ChunkList<T, N, Allocator, Indexed, InlineFirst>& list, bool checksum = false) {
+        static_assert(std::is_trivially_copyable_v<T>, "binary images need trivially copyable elements");
+        BinaryHeader header{binary_magic, binary_version, checksum ? binary_checksum : std::uint16_t(0),
+                            N, sizeof(T), static_cast<std::uint64_t>(list.get_size())};
+        Checksum digest;
+        std::uint64_t digest_value = 0;
+        std::vector<iovec> batch;
+        batch.push_back({&header, sizeof(header)});
+        for (auto segment : list.segments()) {
+            if (segment.empty()) {
+                continue;
+            }
+            if (checksum) {
+                digest.Update(segment.data(), segment.size_bytes());
+            }
+            batch.push_back({const_cast<T*>(segment.data()), segment.size_bytes()});
+            if (batch.size() == detail::binary_batch) {
+                detail::WriteAll(fd, batch);
+                batch.clear();
+            }
+        }
+        if (checksum) {
+            digest_value = digest.Digest();
+            batch.push_back({&digest_value, sizeof(digest_value)});
+        }
+        detail::WriteAll(fd, batch);
+    }
+
+    // Replaces the contents of list with the image read from fd. The payload
+    // is read into fresh chunks with one readv per batch of chunks. On
+    // failure the list is left empty.
+    template <typename T, int N, typename Allocator, bool Indexed, bool InlineFirst>
+    void read_binary(int fd, ChunkList<T, N, Allocator, Indexed, InlineFirst>& list) {
+        static_assert(std::is_trivially_copyable_v<T>, "binary images need trivially copyable elements");
+        BinaryAccess::Read(fd, list);
+    }
+}
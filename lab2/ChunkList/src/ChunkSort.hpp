@@ -0,0 +1,374 @@
+#pragma once
+#include "ChunkList.hpp"
+#include "ParallelAlgorithms.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace fefu_laboratory_two {
+    // Sorting works in two steps. Every chunk is sorted in place first, and
+    // those sorts are independent, so they can run on a ThreadPool. The sorted
+    // chunks are then merged on a loser tree, one comparison per level. Each
+    // level costs a hard-to-predict branch, and wide trees also lose the
+    // hardware prefetcher across their many input streams, so runs are merged
+    // fan_in at a time over a few passes. Each pass writes chains of chunks
+    // and recycles every input chunk as soon as it is drained, so it mostly
+    // writes into chunks it has just emptied.
+    struct SortAccess {
+        static constexpr std::size_t fan_in = 4;
+
+        // Merges the first ordered elements; the rest follow in no particular
+        // order. Each chunk must hold its own sorted prefix of that length.
+        template <typename T, int N, typename Allocator, bool Indexed, bool InlineFirst, typename Compare>
+        static void Merge(ChunkList<T, N, Allocator, Indexed, InlineFirst>& list, Compare& compare, std::size_t ordered) {
+            if (list.chunk_count < 2) {
+                return;
+            }
+            std::vector<Run<T>> runs;
+            std::vector<Run<T>> merged;
+            runs.reserve(list.chunk_count);
+            merged.reserve((list.chunk_count + fan_in - 1) / fan_in);
+            list.directory.reserve(list.chunk_count * 2 + 2);
+            int chunk_size = 0;
+            for (Chunk<T>* chunk = list.start; chunk != nullptr; chunk = chunk->next) {
+                T* data = chunk->data();
+                runs.push_back({chunk, data, data + chunk->current_size,
+                                std::min<std::size_t>(chunk->current_size, ordered)});
+                chunk_size = std::max(chunk_size, chunk->size);
+            }
+            for (Run<T>& run : runs) {
+                run.chunk->prev = nullptr;
+                run.chunk->next = nullptr;
+            }
+            list.start = nullptr;
+            list.tail = nullptr;
+            list.size = 0;
+            list.chunk_count = 0;
+            list.uniform = true;
+            list.directory.clear();
+
+            try {
+                while (runs.size() > fan_in) {
+                    merged.clear();
+                    for (std::size_t first = 0; first < runs.size(); first += fan_in) {
+                        merged.push_back({});
+                        ChainOutput<T, ChunkList<T, N, Allocator, Indexed, InlineFirst>> output{list, merged.back(), chunk_size};
+                        std::span<Run<T>> group(runs.data() + first, std::min(fan_in, runs.size() - first));
+                        merged.back().sorted = MergeRuns(list, group, compare, ordered, output);
+                    }
+                    runs.swap(merged);
+                }
+                ListOutput<ChunkList<T, N, Allocator, Indexed, InlineFirst>> output{list};
+                MergeRuns(list, std::span<Run<T>>(runs), compare, ordered, output);
+            }
+            catch (...) {
+                for (Run<T>& run : runs) {
+                    Restore(list, run);
+                }
+                for (Run<T>& run : merged) {
+                    Restore(list, run);
+                }
+                throw;
+            }
+        }
+
+    private:
+        // A chain of chunks linked through next. current and end bound what is
+        // left of the first chunk, and the next sorted elements are in order.
+        template <typename T>
+        struct Run {
+            Chunk<T>* chunk = nullptr;
+            T* current = nullptr;
+            T* end = nullptr;
+            std::size_t sorted = 0;
+        };
+
+        template <typename List>
+        struct ListOutput {
+            List& list;
+
+            auto* Reserve() {
+                return list.ReserveBack();
+            }
+
+            template <typename Chunk>
+            void Commit(Chunk* chunk) noexcept {
+                chunk->current_size++;
+                list.size++;
+            }
+
+            template <typename T>
+            void Splice(Run<T>& run) noexcept {
+                Restore(list, run);
+            }
+        };
+
+        template <typename T, typename List>
+        struct ChainOutput {
+            List& list;
+            Run<T>& run;
+            int chunk_size;
+            Chunk<T>* last = nullptr;
+
+            Chunk<T>* Reserve() {
+                Chunk<T>* chunk = list.AcquireChunk(chunk_size);
+                Append(chunk);
+                return chunk;
+            }
+
+            void Commit(Chunk<T>* chunk) noexcept {
+                chunk->current_size++;
+                if (chunk == run.chunk) {
+                    run.end++;
+                }
+            }
+
+            void Splice(Run<T>& other) noexcept {
+                Settle(list, other);
+                if (other.chunk == nullptr) {
+                    return;
+                }
+                Chunk<T>* chunk = other.chunk;
+                Trim(list, other);
+                while (chunk != nullptr) {
+                    Chunk<T>* next = chunk->next;
+                    Append(chunk);
+                    chunk = next;
+                }
+            }
+
+            void Append(Chunk<T>* chunk) noexcept {
+                chunk->prev = last;
+                chunk->next = nullptr;
+                if (last != nullptr) {
+                    last->next = chunk;
+                }
+                else {
+                    run.chunk = chunk;
+                    run.current = chunk->data();
+                    run.end = run.current + chunk->current_size;
+                }
+                last = chunk;
+            }
+        };
+
+        template <typename List, typename T, typename Compare, typename Output>
+        static std::size_t MergeRuns(List& list, std::span<Run<T>> runs, Compare& compare, std::size_t ordered,
+                                     Output& output) {
+            for (Run<T>& run : runs) {
+                Settle(list, run);
+            }
+            LoserTree<T, Compare> tree(runs, compare);
+            std::size_t written = 0;
+            Chunk<T>* chunk = nullptr;
+            for (; written < ordered && tree.HasWinner(); written++) {
+                if (chunk == nullptr || chunk->GetFreeSlots() == 0) {
+                    chunk = output.Reserve();
+                }
+                Run<T>& run = tree.Winner();
+                list.ConstructAt(chunk->data() + chunk->current_size, std::move(*run.current));
+                output.Commit(chunk);
+                run.current++;
+                run.sorted--;
+                Settle(list, run);
+                tree.Replay();
+            }
+            for (Run<T>& run : runs) {
+                output.Splice(run);
+            }
+            return written;
+        }
+
+        // Recycles drained chunks at the front of a run.
+        template <typename List, typename T>
+        static void Settle(List& list, Run<T>& run) noexcept {
+            while (run.chunk != nullptr && run.current == run.end) {
+                Chunk<T>* next = run.chunk->next;
+                list.DropChunk(run.chunk);
+                run.chunk = next;
+                if (next != nullptr) {
+                    run.current = next->data();
+                    run.end = run.current + next->current_size;
+                }
+            }
+        }
+
+        // Destroys the moved-from prefix of the first chunk and hands the
+        // chain over to the caller.
+        template <typename List, typename T>
+        static void Trim(List& list, Run<T>& run) noexcept {
+            Chunk<T>* chunk = run.chunk;
+            int consumed = static_cast<int>(run.current - chunk->data());
+            list.DestroyRange(chunk->data(), run.current);
+            chunk->begin_offset += consumed;
+            chunk->current_size -= consumed;
+            run = {};
+        }
+
+        // Links what is left of a run at the tail of the list.
+        template <typename List, typename T>
+        static void Restore(List& list, Run<T>& run) noexcept {
+            Settle(list, run);
+            if (run.chunk == nullptr) {
+                return;
+            }
+            Chunk<T>* chunk = run.chunk;
+            Trim(list, run);
+            while (chunk != nullptr) {
+                Chunk<T>* next = chunk->next;
+                chunk->prev = list.tail;
+                chunk->next = nullptr;
+                if (list.tail != nullptr) {
+                    list.tail->next = chunk;
+                }
+                else {
+                    list.start = chunk;
+                }
+                list.tail = chunk;
+                list.directory.push_back(chunk);
+                list.chunk_count++;
+                list.size += chunk->current_size;
+                chunk = next;
+            }
+            list.uniform = false;
+        }
+
+        // Internal nodes hold the run that lost the match there, node 0 the
+        // overall winner. Each node caches the head of its run, null once the
+        // run has no sorted elements left, so a replay does not go back to
+        // the runs. A run beats another when its head is smaller, or when the
+        // heads are equal and it comes first, which keeps the merge stable.
+        template <typename T, typename Compare>
+        class LoserTree {
+        public:
+            LoserTree(std::span<Run<T>> runs, Compare& compare) :
+                    runs(runs), compare(compare), leaves(std::bit_ceil(runs.size())), nodes(leaves) {
+                nodes[0] = Build(1);
+            }
+
+            bool HasWinner() const noexcept {
+                return nodes[0].head != nullptr;
+            }
+
+            Run<T>& Winner() noexcept {
+                return runs[nodes[0].run];
+            }
+
+            void Replay() {
+                Node winner = Leaf(nodes[0].run);
+                for (std::size_t node = (winner.run + leaves) / 2; node > 0; node /= 2) {
+                    if (Beats(nodes[node], winner)) {
+                        std::swap(nodes[node], winner);
+                    }
+                }
+                nodes[0] = winner;
+            }
+
+        private:
+            struct Node {
+                std::size_t run = 0;
+                const T* head = nullptr;
+            };
+
+            std::span<Run<T>> runs;
+            Compare& compare;
+            std::size_t leaves;
+            std::vector<Node> nodes;
+
+            Node Leaf(std::size_t run) const noexcept {
+                if (run < runs.size() && runs[run].sorted > 0) {
+                    return {run, runs[run].current};
+                }
+                return {run, nullptr};
+            }
+
+            bool Beats(const Node& first, const Node& second) {
+                if (first.head == nullptr || second.head == nullptr) {
+                    return first.head != nullptr || (second.head == nullptr && first.run < second.run);
+                }
+                // Written without a branch on the order of the two runs, which
+                // the predictor cannot learn.
+                bool earlier = first.run < second.run;
+                const T& left = earlier ? *second.head : *first.head;
+                const T& right = earlier ? *first.head : *second.head;
+                return static_cast<bool>(compare(left, right)) != earlier;
+            }
+
+            Node Build(std::size_t node) {
+                if (node >= leaves) {
+                    return Leaf(node - leaves);
+                }
+                Node left = Build(node * 2);
+                Node right = Build(node * 2 + 1);
+                if (Beats(left, right)) {
+                    nodes[node] = right;
+                    return left;
+                }
+                nodes[node] = left;
+                return right;
+            }
+        };
+    };
+
+    template <typename T, int N, typename Allocator, bool Indexed, bool InlineFirst, typename Compare = std::less<>>
+    void sort(ChunkList<T, N, Allocator, Indexed, InlineFirst>& list, Compare compare = Compare()) {
+        for (std::span<T> segment : list.segments()) {
+            std::sort(segment.begin(), segment.end(), compare);
+        }
+        SortAccess::Merge(list, compare, list.get_size());
+    }
+
+    template <typename T, int N, typename Allocator, bool Indexed, bool InlineFirst, typename Compare = std::less<>>
+    void stable_sort(ChunkList<T, N, Allocator, Indexed, InlineFirst>& list, Compare compare = Compare()) {
+        for (std::span<T> segment : list.segments()) {
+            std::stable_sort(segment.begin(), segment.end(), compare);
+        }
+        SortAccess::Merge(list, compare, list.get_size());
+    }
+
+    // Leaves the count smallest elements sorted at the front; the order of
+    // the rest is unspecified. Each chunk only sorts the part of it that can
+    // reach the front.
+    template <typename T, int N, typename Allocator, bool Indexed, bool InlineFirst, typename Compare = std::less<>>
+    void partial_sort(ChunkList<T, N, Allocator, Indexed, InlineFirst>& list, std::size_t count, Compare compare = Compare()) {
+        count = std::min<std::size_t>(count, list.get_size());
+        for (std::span<T> segment : list.segments()) {
+            if (count >= segment.size()) {
+                std::sort(segment.begin(), segment.end(), compare);
+            }
+            else {
+                std::partial_sort(segment.begin(), segment.begin() + count, segment.end(), compare);
+            }
+        }
+        SortAccess::Merge(list, compare, count);
+    }
+
+    namespace parallel {
+        template <typename T, int N, typename Allocator, bool Indexed, bool InlineFirst, typename Compare = std::less<>>
+        void sort(ChunkList<T, N, Allocator, Indexed, InlineFirst>& list, Compare compare = Compare(),
+                  ThreadPool& pool = ThreadPool::Default()) {
+            detail::WorkSplit<ChunkList<T, N, Allocator, Indexed, InlineFirst>> split(list, pool);
+            pool.ParallelFor(split.GetTaskCount(), [&](std::size_t task) {
+                for (std::size_t i = split.bounds[task]; i < split.bounds[task + 1]; i++) {
+                    std::sort(split.segments[i].begin(), split.segments[i].end(), compare);
+                }
+            });
+            SortAccess::Merge(list, compare, list.get_size());
+        }
+
+        template <typename T, int N, typename Allocator, bool Indexed, bool InlineFirst, typename Compare = std::less<>>
+        void stable_sort(ChunkList<T, N, Allocator, Indexed, InlineFirst>& list, Compare compare = Compare(),
+                         ThreadPool& pool = ThreadPool::Default()) {
+            detail::WorkSplit<ChunkList<T, N, Allocator, Indexed, InlineFirst>> split(list, pool);
+            pool.ParallelFor(split.GetTaskCount(), [&](std::size_t task) {
+                for (std::size_t i = split.bounds[task]; i < split.bounds[task + 1]; i++) {
+                    std::stable_sort(split.segments[i].begin(), split.segments[i].end(), compare);
+                }
+            });
+            SortAccess::Merge(list, compare, list.get_size());
+        }
+    }
+}
@@ -0,0 +1,671 @@
+#pragma once
+#include "ChunkList.hpp"
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fefu_laboratory_two {
+    inline constexpr int default_columnar_rows = 1024;
+
+    // A row of a ColumnarChunkList: one pointer per field, since the fields
+    // live in different arrays. Assigning through it writes the fields, and
+    // it converts to the tuple it stands for.
+    template <bool Const, typename... Fields>
+    class ColumnarChunkList_reference {
+    public:
+        using value_type = std::tuple<Fields...>;
+        using pointers = std::tuple<std::conditional_t<Const, const Fields*, Fields*>...>;
+
+        explicit ColumnarChunkList_reference(pointers fields) noexcept : fields(fields) {}
+
+        ColumnarChunkList_reference(const ColumnarChunkList_reference& other) noexcept = default;
+
+        ColumnarChunkList_reference(const ColumnarChunkList_reference<false, Fields...>& other) noexcept
+            requires Const : fields(other.fields) {}
+
+        template <std::size_t I>
+        auto& get() const noexcept {
+            return *std::get<I>(fields);
+        }
+
+        operator value_type() const {
+            return std::apply([](auto*... field) { return value_type(*field...); }, fields);
+        }
+
+        const ColumnarChunkList_reference& operator=(const value_type& value) const requires (!Const) {
+            Assign(value, std::index_sequence_for<Fields...>());
+            return *this;
+        }
+
+        const ColumnarChunkList_reference& operator=(value_type&& value) const requires (!Const) {
+            Assign(std::move(value), std::index_sequence_for<Fields...>());
+            return *this;
+        }
+
+        const ColumnarChunkList_reference& operator=(const ColumnarChunkList_reference& other) const
+            requires (!Const) {
+            Assign(value_type(other), std::index_sequence_for<Fields...>());
+            return *this;
+        }
+
+        friend bool operator==(const ColumnarChunkList_reference& first, const value_type& second) {
+            return value_type(first) == second;
+        }
+
+        friend bool operator==(const ColumnarChunkList_reference& first, const ColumnarChunkList_reference& second) {
+            return value_type(first) == value_type(second);
+        }
+
+    private:
+        friend class ColumnarChunkList_reference<true, Fields...>;
+
+        pointers fields;
+
+        template <typename Tuple, std::size_t... I>
+        void Assign(Tuple&& value, std::index_sequence<I...>) const {
+            ((*std::get<I>(fields) = std::get<I>(std::forward<Tuple>(value))), ...);
+        }
+    };
+
+    // One field of every row, read chunk by chunk. It has segments() and
+    // begin(), so the segmented algorithms in SegmentedAlgorithms.hpp scan a
+    // single column and use the SIMD kernels for arithmetic fields.
+    template <typename Field, typename ValueType, int N>
+    class ColumnarChunkList_column {
+    public:
+        using value_type = std::remove_const_t<Field>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using chunk_type = Chunk<ValueType>;
+
+        class iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::remove_const_t<Field>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = Field*;
+            using reference = Field&;
+
+            iterator() noexcept = default;
+
+            iterator(chunk_type* const* chunks, std::size_t column_offset, size_type index) noexcept :
+                    chunks(chunks), column_offset(column_offset), index(index) {}
+
+            reference operator*() const noexcept {
+                return At(index);
+            }
+
+            pointer operator->() const noexcept {
+                return &At(index);
+            }
+
+            reference operator[](difference_type offset) const noexcept {
+                return At(index + offset);
+            }
+
+            iterator& operator++() noexcept {
+                index++;
+                return *this;
+            }
+
+            iterator operator++(int) noexcept {
+                iterator previous = *this;
+                index++;
+                return previous;
+            }
+
+            iterator& operator--() noexcept {
+                index--;
+                return *this;
+            }
+
+            iterator operator--(int) noexcept {
+                iterator previous = *this;
+                index--;
+                return previous;
+            }
+
+            iterator& operator+=(difference_type offset) noexcept {
+                index += offset;
+                return *this;
+            }
+
+            iterator& operator-=(difference_type offset) noexcept {
+                index -= offset;
+                return *this;
+            }
+
+            friend iterator operator+(iterator first, difference_type offset) noexcept {
+                return first += offset;
+            }
+
+            friend iterator operator+(difference_type offset, iterator first) noexcept {
+                return first += offset;
+            }
+
+            friend iterator operator-(iterator first, difference_type offset) noexcept {
+                return first -= offset;
+            }
+
+            friend difference_type operator-(const iterator& first, const iterator& second) noexcept {
+                return static_cast<difference_type>(first.index) - static_cast<difference_type>(second.index);
+            }
+
+            friend bool operator==(const iterator& first, const iterator& second) noexcept {
+                return first.index == second.index;
+            }
+
+            friend auto operator<=>(const iterator& first, const iterator& second) noexcept {
+                return first.index <=> second.index;
+            }
+
+        private:
+            chunk_type* const* chunks = nullptr;
+            std::size_t column_offset = 0;
+            size_type index = 0;
+
+            reference At(size_type position) const noexcept {
+                return ColumnarChunkList_column::Base(chunks[position / N], column_offset)[position % N];
+            }
+        };
+
+        class segments_range {
+        public:
+            class iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = std::span<Field>;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = std::span<Field>;
+
+                iterator() noexcept = default;
+
+                iterator(chunk_type* chunk, std::size_t offset) noexcept : chunk(chunk), offset(offset) {}
+
+                reference operator*() const noexcept {
+                    return reference(ColumnarChunkList_column::Base(chunk, offset), chunk->current_size);
+                }
+
+                iterator& operator++() noexcept {
+                    chunk = chunk->next;
+                    return *this;
+                }
+
+                iterator operator++(int) noexcept {
+                    iterator previous = *this;
+                    chunk = chunk->next;
+                    return previous;
+                }
+
+                friend bool operator==(const iterator& first, const iterator& second) noexcept {
+                    return first.chunk == second.chunk;
+                }
+
+            private:
+                chunk_type* chunk = nullptr;
+                std::size_t offset = 0;
+            };
+
+            segments_range(chunk_type* start, std::size_t offset) noexcept : start(start), offset(offset) {}
+
+            iterator begin() const noexcept {
+                return iterator(start, offset);
+            }
+
+            iterator end() const noexcept {
+                return iterator(nullptr, offset);
+            }
+
+        private:
+            chunk_type* start;
+            std::size_t offset;
+        };
+
+        ColumnarChunkList_column(chunk_type* const* chunks, size_type chunk_count, size_type count,
+                                 std::size_t offset) noexcept :
+                chunks(chunks), chunk_count(chunk_count), count(count), offset(offset) {}
+
+        Field& operator[](size_type position) const noexcept {
+            return Base(chunks[position / N], offset)[position % N];
+        }
+
+        iterator begin() const noexcept {
+            return iterator(chunks, offset, 0);
+        }
+
+        iterator end() const noexcept {
+            return iterator(chunks, offset, count);
+        }
+
+        segments_range segments() const noexcept {
+            return segments_range(chunk_count == 0 ? nullptr : chunks[0], offset);
+        }
+
+        bool empty() const noexcept {
+            return count == 0;
+        }
+
+        size_type get_size() const noexcept {
+            return count;
+        }
+
+    private:
+        chunk_type* const* chunks;
+        size_type chunk_count;
+        size_type count;
+        std::size_t offset;
+
+        static Field* Base(chunk_type* chunk, std::size_t offset) noexcept {
+            return reinterpret_cast<Field*>(reinterpret_cast<std::byte*>(chunk->storage()) + offset);
+        }
+    };
+
+    // Rows of Fields... kept column by column: every chunk holds N rows as one
+    // array per field, so a scan over one field reads only that field's bytes.
+    // The chunks are ordinary Chunk blocks from a ChunkPool, sized to fit the
+    // columns back to back with each column aligned like a chunk, and linked
+    // through prev/next like a ChunkList chain. Rows are added and removed at
+    // the back only, so every chunk but the last is full and a row is found by
+    // division through a vector of the chunk pointers.
+    template <int N, typename... Fields>
+    class BasicColumnarChunkList {
+        static_assert(N > 0 && sizeof...(Fields) > 0);
+
+    public:
+        using value_type = std::tuple<Fields...>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = ColumnarChunkList_reference<false, Fields...>;
+        using const_reference = ColumnarChunkList_reference<true, Fields...>;
+
+        template <std::size_t I>
+        using field_type = std::tuple_element_t<I, value_type>;
+
+        template <bool Const>
+        class basic_iterator {
+        public:
+            using iterator_concept = std::random_access_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type = std::tuple<Fields...>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = ColumnarChunkList_reference<Const, Fields...>;
+            using list_pointer = std::conditional_t<Const, const BasicColumnarChunkList*, BasicColumnarChunkList*>;
+
+            basic_iterator() noexcept = default;
+
+            basic_iterator(list_pointer list, size_type index) noexcept : list(list), index(index) {}
+
+            basic_iterator(const basic_iterator& other) noexcept = default;
+
+            basic_iterator(const basic_iterator<false>& other) noexcept requires Const :
+                    list(other.list), index(other.index) {}
+
+            reference operator*() const noexcept {
+                return (*list)[index];
+            }
+
+            reference operator[](difference_type offset) const noexcept {
+                return (*list)[index + offset];
+            }
+
+            basic_iterator& operator++() noexcept {
+                index++;
+                return *this;
+            }
+
+            basic_iterator operator++(int) noexcept {
+                basic_iterator previous = *this;
+                index++;
+                return previous;
+            }
+
+            basic_iterator& operator--() noexcept {
+                index--;
+                return *this;
+            }
+
+            basic_iterator operator--(int) noexcept {
+                basic_iterator previous = *this;
+                index--;
+                return previous;
+            }
+
+            basic_iterator& operator+=(difference_type offset) noexcept {
+                index += offset;
+                return *this;
+            }
+
+            basic_iterator& operator-=(difference_type offset) noexcept {
+                index -= offset;
+                return *this;
+            }
+
+            friend basic_iterator operator+(basic_iterator first, difference_type offset) noexcept {
+                return first += offset;
+            }
+
+            friend basic_iterator operator+(difference_type offset, basic_iterator first) noexcept {
+                return first += offset;
+            }
+
+            friend basic_iterator operator-(basic_iterator first, difference_type offset) noexcept {
+                return first -= offset;
+            }
+
+            friend difference_type operator-(const basic_iterator& first, const basic_iterator& second) noexcept {
+                return static_cast<difference_type>(first.index) - static_cast<difference_type>(second.index);
+            }
+
+            friend bool operator==(const basic_iterator& first, const basic_iterator& second) noexcept {
+                return first.index == second.index;
+            }
+
+            friend auto operator<=>(const basic_iterator& first, const basic_iterator& second) noexcept {
+                return first.index <=> second.index;
+            }
+
+        private:
+            friend class basic_iterator<true>;
+
+            list_pointer list = nullptr;
+            size_type index = 0;
+        };
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        template <std::size_t I>
+        using column_type = ColumnarChunkList_column<field_type<I>, value_type, N>;
+
+        template <std::size_t I>
+        using const_column_type = ColumnarChunkList_column<const field_type<I>, value_type, N>;
+
+        BasicColumnarChunkList() noexcept = default;
+
+        BasicColumnarChunkList(const BasicColumnarChunkList& other) {
+            try {
+                chunks.reserve(other.chunks.size());
+                for (size_type i = 0; i < other.count; i++) {
+                    CopyRow(other[i], std::index_sequence_for<Fields...>());
+                }
+            }
+            catch (...) {
+                clear();
+                throw;
+            }
+        }
+
+        BasicColumnarChunkList(BasicColumnarChunkList&& other) noexcept {
+            swap(other);
+        }
+
+        BasicColumnarChunkList& operator=(const BasicColumnarChunkList& other) {
+            if (this != &other) {
+                BasicColumnarChunkList copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        BasicColumnarChunkList& operator=(BasicColumnarChunkList&& other) noexcept {
+            if (this != &other) {
+                clear();
+                swap(other);
+            }
+            return *this;
+        }
+
+        ~BasicColumnarChunkList() {
+            clear();
+        }
+
+        void swap(BasicColumnarChunkList& other) noexcept {
+            chunks.swap(other.chunks);
+            std::swap(count, other.count);
+        }
+
+        reference operator[](size_type position) noexcept {
+            return MakeReference<false>(chunks[position / N], position % N, std::index_sequence_for<Fields...>());
+        }
+
+        const_reference operator[](size_type position) const noexcept {
+            return MakeReference<true>(chunks[position / N], position % N, std::index_sequence_for<Fields...>());
+        }
+
+        reference at(size_type position) {
+            if (position >= count) {
+                throw std::out_of_range("out of range");
+            }
+            return (*this)[position];
+        }
+
+        const_reference at(size_type position) const {
+            if (position >= count) {
+                throw std::out_of_range("out of range");
+            }
+            return (*this)[position];
+        }
+
+        reference front() {
+            return at(0);
+        }
+
+        const_reference front() const {
+            return at(0);
+        }
+
+        reference back() {
+            if (count == 0) {
+                throw std::out_of_range("empty");
+            }
+            return (*this)[count - 1];
+        }
+
+        const_reference back() const {
+            if (count == 0) {
+                throw std::out_of_range("empty");
+            }
+            return (*this)[count - 1];
+        }
+
+        template <std::size_t I>
+        column_type<I> column() noexcept {
+            return column_type<I>(chunks.data(), chunks.size(), count, offsets[I]);
+        }
+
+        template <std::size_t I>
+        const_column_type<I> column() const noexcept {
+            return const_column_type<I>(chunks.data(), chunks.size(), count, offsets[I]);
+        }
+
+        iterator begin() noexcept {
+            return iterator(this, 0);
+        }
+
+        iterator end() noexcept {
+            return iterator(this, count);
+        }
+
+        const_iterator begin() const noexcept {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const noexcept {
+            return const_iterator(this, count);
+        }
+
+        const_iterator cbegin() const noexcept {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept {
+            return end();
+        }
+
+        bool empty() const noexcept {
+            return count == 0;
+        }
+
+        size_type get_size() const noexcept {
+            return count;
+        }
+
+        size_type get_chunk_count() const noexcept {
+            return chunks.size();
+        }
+
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            static_assert(sizeof...(Args) == sizeof...(Fields), "emplace_back takes one argument per field");
+            if (count == chunks.size() * N) {
+                chunk_type* chunk = pool.Acquire(storage_rows);
+                try {
+                    chunks.push_back(chunk);
+                }
+                catch (...) {
+                    pool.Release(chunk);
+                    throw;
+                }
+                if (chunks.size() > 1) {
+                    chunk->prev = chunks[chunks.size() - 2];
+                    chunk->prev->next = chunk;
+                }
+            }
+            chunk_type* chunk = chunks.back();
+            try {
+                ConstructRow(chunk, chunk->current_size, std::index_sequence_for<Fields...>(),
+                             std::forward<Args>(args)...);
+            }
+            catch (...) {
+                if (chunk->current_size == 0) {
+                    ReleaseBack();
+                }
+                throw;
+            }
+            chunk->current_size++;
+            count++;
+            return (*this)[count - 1];
+        }
+
+        void push_back(const value_type& value) {
+            std::apply([this](const auto&... field) { emplace_back(field...); }, value);
+        }
+
+        void push_back(value_type&& value) {
+            std::apply([this](auto&... field) { emplace_back(std::move(field)...); }, value);
+        }
+
+        void pop_back() {
+            if (count == 0) {
+                throw std::out_of_range("empty");
+            }
+            chunk_type* chunk = chunks.back();
+            chunk->current_size--;
+            count--;
+            DestroyRow(chunk, chunk->current_size, std::index_sequence_for<Fields...>());
+            if (chunk->current_size == 0) {
+                ReleaseBack();
+            }
+        }
+
+        void clear() noexcept {
+            while (!chunks.empty()) {
+                chunk_type* chunk = chunks.back();
+                for (int row = 0; row < chunk->current_size; row++) {
+                    DestroyRow(chunk, row, std::index_sequence_for<Fields...>());
+                }
+                ReleaseBack();
+            }
+            count = 0;
+        }
+
+    private:
+        using chunk_type = Chunk<value_type>;
+
+        static constexpr std::size_t column_alignment = chunk_alignment<value_type>;
+
+        static constexpr std::array<std::size_t, sizeof...(Fields) + 1> offsets = [] {
+            std::array<std::size_t, sizeof...(Fields) + 1> result{};
+            std::size_t sizes[] = {sizeof(Fields)...};
+            for (std::size_t i = 0; i < sizeof...(Fields); i++) {
+                std::size_t end = result[i] + sizes[i] * N;
+                result[i + 1] = (end + column_alignment - 1) / column_alignment * column_alignment;
+            }
+            return result;
+        }();
+
+        // Chunk sizes count value_type slots, so the columns are rounded up
+        // to whole tuples.
+        static constexpr int storage_rows =
+                static_cast<int>((offsets.back() + sizeof(value_type) - 1) / sizeof(value_type));
+
+        ChunkPool<value_type> pool;
+        std::vector<chunk_type*> chunks;
+        size_type count = 0;
+
+        template <std::size_t I>
+        static field_type<I>* Column(chunk_type* chunk) noexcept {
+            return reinterpret_cast<field_type<I>*>(reinterpret_cast<std::byte*>(chunk->storage()) + offsets[I]);
+        }
+
+        template <bool Const, std::size_t... I>
+        static ColumnarChunkList_reference<Const, Fields...> MakeReference(chunk_type* chunk, size_type row,
+                                                                            std::index_sequence<I...>) noexcept {
+            return ColumnarChunkList_reference<Const, Fields...>(std::make_tuple(Column<I>(chunk) + row...));
+        }
+
+        template <std::size_t... I, typename... Args>
+        static void ConstructRow(chunk_type* chunk, int row, std::index_sequence<I...>, Args&&... args) {
+            std::size_t constructed = 0;
+            try {
+                ((::new (static_cast<void*>(Column<I>(chunk) + row)) field_type<I>(std::forward<Args>(args)),
+                  constructed++), ...);
+            }
+            catch (...) {
+                ((I < constructed ? std::destroy_at(Column<I>(chunk) + row) : void()), ...);
+                throw;
+            }
+        }
+
+        template <std::size_t... I>
+        static void DestroyRow(chunk_type* chunk, int row, std::index_sequence<I...>) noexcept {
+            (std::destroy_at(Column<I>(chunk) + row), ...);
+        }
+
+        template <std::size_t... I>
+        void CopyRow(const_reference row, std::index_sequence<I...>) {
+            emplace_back(row.template get<I>()...);
+        }
+
+        void ReleaseBack() noexcept {
+            pool.Release(chunks.back());
+            chunks.pop_back();
+            if (!chunks.empty()) {
+                chunks.back()->next = nullptr;
+            }
+        }
+    };
+
+    template <typename... Fields>
+    using ColumnarChunkList = BasicColumnarChunkList<default_columnar_rows, Fields...>;
+}
+
+template <bool Const, typename... Fields>
+struct std::tuple_size<fefu_laboratory_two::ColumnarChunkList_reference<Const, Fields...>> :
+        std::integral_constant<std::size_t, sizeof...(Fields)> {};
+
+template <std::size_t I, bool Const, typename... Fields>
+struct std::tuple_element<I, fefu_laboratory_two::ColumnarChunkList_reference<Const, Fields...>> {
+    using type = std::conditional_t<Const, const std::tuple_element_t<I, std::tuple<Fields...>>&,
+                                    std::tuple_element_t<I, std::tuple<Fields...>>&>;
+};
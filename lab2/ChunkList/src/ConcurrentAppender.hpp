@@ -0,0 +1,225 @@
+#pragma once
+#include "ChunkList.hpp"
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+namespace fefu_laboratory_two {
+    // Lets several threads append to one ChunkList without a mutex. Producers
+    // claim slots in the tail chunk with fetch_add on Chunk::claimed and count
+    // finished elements in Chunk::current_size. The producer that overflows a
+    // chunk links the next one with a CAS on Chunk::next.
+    //
+    // Readers see a published size. It grows when the oldest unpublished chunk
+    // is completely written, so the published prefix never contains a
+    // half-constructed element. While the appender is attached, only its own
+    // member functions may touch the list. Quiesce() (or the destructor) must
+    // run after every producer has returned. It writes the final size and
+    // tail back into the list, which can then be used normally again.
+    template <typename T, int N, typename Allocator, bool Indexed, bool InlineFirst>
+    class ConcurrentAppender {
+    public:
+        using list_type = ChunkList<T, N, Allocator, Indexed, InlineFirst>;
+        using value_type = T;
+        using size_type = std::size_t;
+
+        explicit ConcurrentAppender(list_type& list) : list(&list) {
+            if (list.tail == nullptr) {
+                list.AppendChunk();
+            }
+            if (list.maybe_shared) {
+                list.MakeUnique(list.tail, list.chunk_count - 1);
+            }
+            first = list.tail;
+            first_committed = first->current_size;
+            first->claimed = first->current_size;
+            base = list.size;
+            claimable = base + Capacity(first) - first_committed;
+            tail.store(first, std::memory_order_relaxed);
+            publish_chunk.store(first, std::memory_order_relaxed);
+            published.store(base, std::memory_order_relaxed);
+        }
+
+        ConcurrentAppender(const ConcurrentAppender& other) = delete;
+
+        ConcurrentAppender& operator=(const ConcurrentAppender& other) = delete;
+
+        ~ConcurrentAppender() {
+            Quiesce();
+        }
+
+        template <typename... Args>
+        void emplace_back(Args&&... args) {
+            if constexpr (std::is_nothrow_constructible_v<value_type, Args&&...>) {
+                Slot slot = Claim();
+                list->ConstructAt(slot.chunk->data() + slot.index, std::forward<Args>(args)...);
+                Commit(slot.chunk);
+            }
+            else {
+                static_assert(std::is_nothrow_move_constructible_v<value_type>,
+                              "concurrent append needs a non-throwing move constructor");
+                value_type value(std::forward<Args>(args)...);
+                Slot slot = Claim();
+                list->ConstructAt(slot.chunk->data() + slot.index, std::move(value));
+                Commit(slot.chunk);
+            }
+        }
+
+        void push_back(const value_type& value) {
+            emplace_back(value);
+        }
+
+        void push_back(value_type&& value) {
+            emplace_back(std::move(value));
+        }
+
+        size_type GetPublishedSize() const noexcept {
+            return published.load(std::memory_order_acquire);
+        }
+
+        // Calls function on every element of the published prefix, in order,
+        // and returns how many elements were visited.
+        template <typename Function>
+        size_type ForEachPublished(Function function) const {
+            size_type remaining = GetPublishedSize();
+            size_type visited = remaining;
+            for (Chunk<value_type>* chunk = list->start; remaining > 0; chunk = Next(chunk)) {
+                size_type ready = std::atomic_ref<int>(chunk->current_size).load(std::memory_order_acquire);
+                size_type count = std::min(remaining, ready);
+                const value_type* data = chunk->data();
+                for (size_type i = 0; i < count; i++) {
+                    function(data[i]);
+                }
+                remaining -= count;
+            }
+            return visited;
+        }
+
+        void Quiesce() {
+            if (list == nullptr) {
+                return;
+            }
+            size_type appended = 0;
+            Chunk<value_type>* last = tail.load(std::memory_order_acquire);
+            for (Chunk<value_type>* chunk = first; chunk != nullptr; chunk = chunk->next) {
+                appended += chunk->current_size;
+                chunk->claimed = 0;
+            }
+            appended -= first_committed;
+            list->tail = last;
+            list->size = static_cast<int>(base + appended);
+            list->DiscardEmptyTail();
+            published.store(list->size, std::memory_order_release);
+            list = nullptr;
+        }
+
+    private:
+        struct Slot {
+            Chunk<value_type>* chunk;
+            int index;
+        };
+
+        list_type* list;
+        Chunk<value_type>* first = nullptr;
+        int first_committed = 0;
+        size_type base = 0;
+        size_type claimable = 0;
+        std::atomic<Chunk<value_type>*> tail = nullptr;
+        std::atomic<Chunk<value_type>*> publish_chunk = nullptr;
+        std::atomic<size_type> published = 0;
+        std::atomic<bool> failed = false;
+        std::exception_ptr failure;
+
+        static int Capacity(const Chunk<value_type>* chunk) noexcept {
+            return chunk->size - chunk->begin_offset;
+        }
+
+        static Chunk<value_type>* Next(Chunk<value_type>* chunk) noexcept {
+            return std::atomic_ref<Chunk<value_type>*>(chunk->next).load(std::memory_order_acquire);
+        }
+
+        Slot Claim() {
+            if (list == nullptr) {
+                throw std::logic_error("appender is detached");
+            }
+            while (true) {
+                Chunk<value_type>* chunk = tail.load(std::memory_order_acquire);
+                int claimed = std::atomic_ref<int>(chunk->claimed).fetch_add(1, std::memory_order_relaxed);
+                if (claimed < Capacity(chunk)) {
+                    return {chunk, claimed};
+                }
+                if (claimed == Capacity(chunk)) {
+                    Install(chunk);
+                }
+                else {
+                    while (tail.load(std::memory_order_acquire) == chunk) {
+                        if (failed.load(std::memory_order_acquire)) {
+                            std::rethrow_exception(failure);
+                        }
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }
+
+        void Commit(Chunk<value_type>* chunk) noexcept {
+            int committed = std::atomic_ref<int>(chunk->current_size).fetch_add(1, std::memory_order_acq_rel) + 1;
+            if (committed == Capacity(chunk)) {
+                Publish();
+            }
+        }
+
+        // Only the producer whose claim lands exactly one past the end of a
+        // chunk gets here, and the next chunk cannot fill up before it is
+        // linked, so the pool and the directory are never used concurrently.
+        void Install(Chunk<value_type>* chunk) {
+            Chunk<value_type>* next;
+            try {
+                int chunk_size = list->sizing.SizeOf(list->chunk_count);
+                if (static_cast<size_type>(chunk_size) > list->max_size() - claimable) {
+                    throw std::length_error("chunk list exceeds max_size");
+                }
+                next = list->AcquireChunk(chunk_size);
+                try {
+                    list->directory.push_back(next);
+                }
+                catch (...) {
+                    list->ReleaseChunk(next);
+                    throw;
+                }
+            }
+            catch (...) {
+                failure = std::current_exception();
+                failed.store(true, std::memory_order_release);
+                throw;
+            }
+            next->prev = chunk;
+            next->claimed = 0;
+            Chunk<value_type>* expected = nullptr;
+            std::atomic_ref<Chunk<value_type>*>(chunk->next).compare_exchange_strong(
+                    expected, next, std::memory_order_release, std::memory_order_relaxed);
+            list->chunk_count++;
+            claimable += Capacity(next);
+            tail.store(next, std::memory_order_release);
+            Publish();
+        }
+
+        void Publish() noexcept {
+            Chunk<value_type>* chunk = publish_chunk.load(std::memory_order_acquire);
+            while (true) {
+                int ready = std::atomic_ref<int>(chunk->current_size).load(std::memory_order_acquire);
+                Chunk<value_type>* next = Next(chunk);
+                if (ready != Capacity(chunk) || next == nullptr) {
+                    return;
+                }
+                if (publish_chunk.compare_exchange_strong(chunk, next, std::memory_order_acq_rel)) {
+                    size_type fresh = ready - (chunk == first ? first_committed : 0);
+                    published.fetch_add(fresh, std::memory_order_release);
+                    chunk = next;
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,432 @@
+#pragma once
+#include "ChunkList.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fefu_laboratory_two {
+    enum class Advice {
+        Normal = MADV_NORMAL,
+        Sequential = MADV_SEQUENTIAL,
+        Random = MADV_RANDOM,
+        WillNeed = MADV_WILLNEED,
+        DontNeed = MADV_DONTNEED
+    };
+
+    // A file mapped shared into one fixed range of address space and carved
+    // into blocks. The range is reserved up front, so blocks never move while
+    // the file grows. The first page holds the superblock: allocation state
+    // plus the root of the one list the file stores.
+    class MappedFile {
+    public:
+        static constexpr std::size_t default_reservation = std::size_t(64) << 30;
+
+        struct FreeList {
+            std::uint64_t bytes;
+            std::uint64_t head;
+        };
+
+        struct Superblock {
+            std::uint64_t magic;
+            std::uint32_t version;
+            std::uint32_t element_size;
+            std::int32_t chunk_size;
+            std::uint32_t uniform;
+            std::uint64_t base;
+            std::uint64_t used;
+            std::uint64_t size;
+            std::uint64_t start;
+            FreeList free_lists[32];
+        };
+
+        static constexpr std::uint64_t magic = 0x50414D4C43464546ull;
+        static constexpr std::uint32_t version = 1;
+        static constexpr std::size_t header_bytes = 4096;
+        static constexpr std::size_t growth = std::size_t(64) << 20;
+
+        MappedFile(const std::string& path, std::size_t reservation) : reservation(reservation) {
+            fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "open " + path);
+            }
+            try {
+                if (::flock(fd, LOCK_EX | LOCK_NB) != 0) {
+                    throw std::system_error(errno, std::generic_category(), "flock " + path);
+                }
+                struct stat status;
+                if (::fstat(fd, &status) != 0) {
+                    throw std::system_error(errno, std::generic_category(), "fstat " + path);
+                }
+                file_size = static_cast<std::size_t>(status.st_size);
+                fresh = file_size == 0;
+                if (!fresh && file_size < header_bytes) {
+                    throw std::runtime_error("not a mapped chunk list: " + path);
+                }
+                if (fresh) {
+                    Grow(header_bytes);
+                }
+                Superblock header;
+                if (!fresh && ::pread(fd, &header, sizeof(header), 0) != sizeof(header)) {
+                    throw std::runtime_error("not a mapped chunk list: " + path);
+                }
+                void* hint = fresh ? nullptr : reinterpret_cast<void*>(header.base);
+                int flags = MAP_SHARED | MAP_NORESERVE;
+#ifdef MAP_FIXED_NOREPLACE
+                if (hint != nullptr) {
+                    flags |= MAP_FIXED_NOREPLACE;
+                }
+#endif
+                void* memory = ::mmap(hint, reservation, PROT_READ | PROT_WRITE, flags, fd, 0);
+                if (memory == MAP_FAILED && hint != nullptr) {
+                    memory = ::mmap(nullptr, reservation, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, fd, 0);
+                }
+                if (memory == MAP_FAILED) {
+                    throw std::system_error(errno, std::generic_category(), "mmap " + path);
+                }
+                base = static_cast<std::byte*>(memory);
+                if (fresh) {
+                    *Root() = Superblock{magic, version, 0, 0, 1, 0, header_bytes, 0, 0, {}};
+                }
+                else if (Root()->magic != magic || Root()->version != version || Root()->used > file_size ||
+                         file_size > reservation) {
+                    ::munmap(base, reservation);
+                    throw std::runtime_error("not a mapped chunk list: " + path);
+                }
+            }
+            catch (...) {
+                ::close(fd);
+                throw;
+            }
+        }
+
+        MappedFile(const MappedFile& other) = delete;
+
+        MappedFile& operator=(const MappedFile& other) = delete;
+
+        ~MappedFile() {
+            ::munmap(base, reservation);
+            ::close(fd);
+        }
+
+        Superblock* Root() noexcept {
+            return reinterpret_cast<Superblock*>(base);
+        }
+
+        std::byte* GetBase() const noexcept {
+            return base;
+        }
+
+        bool IsFresh() const noexcept {
+            return fresh;
+        }
+
+        std::size_t GetFileSize() const noexcept {
+            return file_size;
+        }
+
+        void* Allocate(std::size_t bytes, std::size_t alignment) {
+            for (FreeList& list : Root()->free_lists) {
+                if (list.bytes == bytes && list.head != 0) {
+                    std::byte* block = base + list.head;
+                    std::memcpy(&list.head, block, sizeof(list.head));
+                    return block;
+                }
+            }
+            std::size_t offset = (Root()->used + alignment - 1) / alignment * alignment;
+            if (offset + bytes > reservation) {
+                throw std::bad_alloc();
+            }
+            if (offset + bytes > file_size) {
+                Grow(offset + bytes);
+            }
+            Root()->used = offset + bytes;
+            return base + offset;
+        }
+
+        // Blocks of a size that finds no free list slot stay allocated in
+        // the file; lists use only a handful of distinct chunk sizes.
+        void Deallocate(void* pointer, std::size_t bytes) noexcept {
+            std::uint64_t offset = static_cast<std::byte*>(pointer) - base;
+            for (FreeList& list : Root()->free_lists) {
+                if (list.bytes == bytes || list.bytes == 0) {
+                    list.bytes = bytes;
+                    std::memcpy(pointer, &list.head, sizeof(list.head));
+                    list.head = offset;
+                    return;
+                }
+            }
+        }
+
+        void Advise(const void* pointer, std::size_t bytes, Advice advice) const noexcept {
+            auto first = reinterpret_cast<std::uintptr_t>(pointer);
+            std::uintptr_t page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+            std::uintptr_t aligned = first / page * page;
+            ::madvise(reinterpret_cast<void*>(aligned), first + bytes - aligned, static_cast<int>(advice));
+        }
+
+        void Sync() {
+            if (::msync(base, Root()->used, MS_SYNC) != 0) {
+                throw std::system_error(errno, std::generic_category(), "msync");
+            }
+        }
+
+    private:
+        int fd = -1;
+        std::byte* base = nullptr;
+        std::size_t reservation;
+        std::size_t file_size = 0;
+        bool fresh = false;
+
+        void Grow(std::size_t required) {
+            std::size_t new_size = std::max({required, file_size * 2, growth});
+            new_size = std::min(new_size, reservation);
+            if (::ftruncate(fd, static_cast<off_t>(new_size)) != 0) {
+                throw std::system_error(errno, std::generic_category(), "ftruncate");
+            }
+            file_size = new_size;
+        }
+    };
+
+    template <typename T>
+    struct IsChunkBlock : std::false_type {};
+
+    template <std::size_t Alignment>
+    struct IsChunkBlock<ChunkBlock<Alignment>> : std::true_type {};
+
+    // Puts chunk blocks into a MappedFile. Everything else a list allocates,
+    // such as its chunk directory, stays on the heap and is rebuilt on open.
+    template <typename T>
+    class MappedAllocator {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        explicit MappedAllocator(MappedFile* file) noexcept : file(file) {}
+
+        template <typename U>
+        MappedAllocator(const MappedAllocator<U>& other) noexcept : file(other.GetFile()) {}
+
+        T* allocate(size_type count) {
+            if constexpr (IsChunkBlock<T>::value) {
+                return static_cast<T*>(file->Allocate(count * sizeof(T), alignof(T)));
+            }
+            else {
+                return std::allocator<T>().allocate(count);
+            }
+        }
+
+        void deallocate(T* pointer, size_type count) noexcept {
+            if constexpr (IsChunkBlock<T>::value) {
+                file->Deallocate(pointer, count * sizeof(T));
+            }
+            else {
+                std::allocator<T>().deallocate(pointer, count);
+            }
+        }
+
+        MappedFile* GetFile() const noexcept {
+            return file;
+        }
+
+        template <typename U>
+        friend bool operator==(const MappedAllocator& lhs, const MappedAllocator<U>& rhs) noexcept {
+            return lhs.GetFile() == rhs.GetFile();
+        }
+
+    private:
+        MappedFile* file;
+    };
+
+    struct MappedAccess {
+        template <typename List>
+        static void Attach(List& list, MappedFile& file) {
+            using chunk_type = std::remove_pointer_t<decltype(list.start)>;
+            MappedFile::Superblock* root = file.Root();
+            list.clear();
+            if (root->start == 0) {
+                return;
+            }
+            if (root->size > list.max_size()) {
+                throw std::length_error("mapped chunk list exceeds max_size");
+            }
+            std::ptrdiff_t delta = file.GetBase() - reinterpret_cast<std::byte*>(root->base);
+            auto relocate = [delta](chunk_type* pointer) {
+                return pointer == nullptr ? nullptr : reinterpret_cast<chunk_type*>(reinterpret_cast<std::byte*>(pointer) + delta);
+            };
+            // The directory is built before any header is rebased, so a
+            // failure leaves the file exactly as it was found.
+            try {
+                for (auto* chunk = reinterpret_cast<chunk_type*>(file.GetBase() + root->start); chunk != nullptr;
+                     chunk = relocate(chunk->next)) {
+                    list.directory.push_back(chunk);
+                    if (list.start == nullptr) {
+                        list.start = chunk;
+                    }
+                    list.tail = chunk;
+                    list.chunk_count++;
+                }
+            }
+            catch (...) {
+                Detach(list);
+                throw;
+            }
+            for (chunk_type* chunk = list.start; chunk != nullptr; chunk = chunk->next) {
+                if (delta != 0) {
+                    chunk->prev = relocate(chunk->prev);
+                    chunk->next = relocate(chunk->next);
+                }
+                chunk->owner = chunk;
+                chunk->references = 1;
+                chunk->claimed = 0;
+            }
+            list.size = static_cast<int>(root->size);
+            list.uniform = root->uniform != 0;
+            root->base = reinterpret_cast<std::uintptr_t>(file.GetBase());
+        }
+
+        // Clones the chunks a copy still shares, so that the chain holds only
+        // blocks of this file. It allocates in the file and may throw.
+        template <typename List>
+        static void Unshare(List& list) {
+            list.Unshare();
+        }
+
+        template <typename List>
+        static void Save(List& list, MappedFile& file) noexcept {
+            MappedFile::Superblock* root = file.Root();
+            root->base = reinterpret_cast<std::uintptr_t>(file.GetBase());
+            root->start = list.start == nullptr ? 0 : reinterpret_cast<std::byte*>(list.start) - file.GetBase();
+            root->size = list.size;
+            root->uniform = list.uniform;
+        }
+
+        template <typename List>
+        static void Detach(List& list) noexcept {
+            list.start = nullptr;
+            list.tail = nullptr;
+            list.size = 0;
+            list.chunk_count = 0;
+            list.uniform = true;
+            list.maybe_shared = false;
+            list.directory.clear();
+        }
+    };
+
+    // A ChunkList whose chunks live in a file. Opening a file that already
+    // holds a list maps it back and relinks its chunk headers; no element is
+    // read or copied. The file is locked while open. Elements must be
+    // trivially copyable, and the list is only consistent on disk after
+    // flush() or destruction; a crash in between can leave it torn. flush()
+    // reports a full file by throwing; the destructor cannot, so if it finds
+    // no room to clone chunks a copy still shares, the file is left as after
+    // a crash.
+    template <typename T, int N, bool Indexed = true>
+    class MappedChunkList {
+    public:
+        using list_type = ChunkList<T, N, MappedAllocator<T>, Indexed>;
+        using size_type = std::size_t;
+
+        static_assert(std::is_trivially_copyable_v<T>, "mapped lists need trivially copyable elements");
+        static_assert(N != dynamic_chunk_size, "mapped lists need a fixed chunk size");
+
+        explicit MappedChunkList(const std::string& path,
+                                 size_type reservation = MappedFile::default_reservation) :
+                file(path, reservation), fresh(Claim(file, path)), list(MappedAllocator<T>(&file)) {
+            if (!fresh) {
+                MappedAccess::Attach(list, file);
+            }
+        }
+
+        MappedChunkList(const MappedChunkList& other) = delete;
+
+        MappedChunkList& operator=(const MappedChunkList& other) = delete;
+
+        ~MappedChunkList() {
+            try {
+                MappedAccess::Unshare(list);
+                MappedAccess::Save(list, file);
+            }
+            catch (...) {
+                // No room to clone shared chunks: the file keeps the list as
+                // the last flush() left it, as after a crash.
+            }
+            MappedAccess::Detach(list);
+            list.get_chunk_pool().Trim(0);
+        }
+
+        list_type& operator*() noexcept {
+            return list;
+        }
+
+        list_type* operator->() noexcept {
+            return &list;
+        }
+
+        list_type& get() noexcept {
+            return list;
+        }
+
+        MappedFile& get_file() noexcept {
+            return file;
+        }
+
+        void flush() {
+            MappedAccess::Unshare(list);
+            MappedAccess::Save(list, file);
+            file.Sync();
+        }
+
+        void advise(Advice advice) const noexcept {
+            file.Advise(file.GetBase(), file.GetFileSize(), advice);
+        }
+
+        // Hints the pages that hold elements [first, first + count).
+        void advise(size_type first, size_type count, Advice advice) const noexcept {
+            for (auto segment : std::as_const(list).segments()) {
+                if (count == 0) {
+                    return;
+                }
+                if (first >= segment.size()) {
+                    first -= segment.size();
+                    continue;
+                }
+                size_type taken = std::min(count, segment.size() - first);
+                file.Advise(segment.data() + first, taken * sizeof(T), advice);
+                first = 0;
+                count -= taken;
+            }
+        }
+
+    private:
+        MappedFile file;
+        bool fresh;
+        list_type list;
+
+        static bool Claim(MappedFile& file, const std::string& path) {
+            MappedFile::Superblock* root = file.Root();
+            if (file.IsFresh()) {
+                root->element_size = sizeof(T);
+                root->chunk_size = N;
+            }
+            else if (root->element_size != sizeof(T) || root->chunk_size != N) {
+                throw std::runtime_error("mapped file holds a different list type: " + path);
+            }
+            return file.IsFresh();
+        }
+    };
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include "SegmentedAlgorithms.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <vector>
+
+namespace fefu_laboratory_two::parallel {
+    namespace detail {
+        template <typename List>
+        using segment_t = std::remove_cvref_t<decltype(*std::declval<List&>().segments().begin())>;
+
+        // The chunk chain cut into runs of whole chunks, one run per task,
+        // with roughly the same number of elements in each run.
+        template <typename List>
+        struct WorkSplit {
+            std::vector<segment_t<List>> segments;
+            std::vector<std::size_t> offsets;
+            std::vector<std::size_t> bounds;
+
+            WorkSplit(List& list, const ThreadPool& pool) {
+                std::size_t total = 0;
+                for (auto segment : list.segments()) {
+                    if (!segment.empty()) {
+                        segments.push_back(segment);
+                        offsets.push_back(total);
+                        total += segment.size();
+                    }
+                }
+                std::size_t tasks = std::min<std::size_t>(segments.size(), pool.GetThreadCount() * 4);
+                bounds.push_back(0);
+                for (std::size_t task = 1; task < tasks; task++) {
+                    std::size_t target = total / tasks * task;
+                    std::size_t segment = bounds.back();
+                    while (segment < segments.size() && offsets[segment] < target) {
+                        segment++;
+                    }
+                    if (segment > bounds.back()) {
+                        bounds.push_back(segment);
+                    }
+                }
+                bounds.push_back(segments.size());
+            }
+
+            std::size_t GetTaskCount() const noexcept {
+                return bounds.size() - 1;
+            }
+        };
+    }
+
+    template <SegmentedList List, typename Function>
+    void for_each(List& list, Function function, ThreadPool& pool = ThreadPool::Default()) {
+        detail::WorkSplit<List> split(list, pool);
+        pool.ParallelFor(split.GetTaskCount(), [&](std::size_t task) {
+            for (std::size_t i = split.bounds[task]; i < split.bounds[task + 1]; i++) {
+                for (auto& value : split.segments[i]) {
+                    function(value);
+                }
+            }
+        });
+    }
+
+    template <SegmentedList List, std::random_access_iterator OutputIt, typename UnaryOperation>
+    OutputIt transform(const List& list, OutputIt destination, UnaryOperation operation,
+                       ThreadPool& pool = ThreadPool::Default()) {
+        detail::WorkSplit<const List> split(list, pool);
+        pool.ParallelFor(split.GetTaskCount(), [&](std::size_t task) {
+            OutputIt output = destination + split.offsets[split.bounds[task]];
+            for (std::size_t i = split.bounds[task]; i < split.bounds[task + 1]; i++) {
+                output = std::transform(split.segments[i].begin(), split.segments[i].end(), output, operation);
+            }
+        });
+        return destination + list.get_size();
+    }
+
+    template <SegmentedList List, typename T, typename BinaryOperation>
+    T reduce(const List& list, T init, BinaryOperation operation, ThreadPool& pool = ThreadPool::Default()) {
+        detail::WorkSplit<const List> split(list, pool);
+        std::vector<std::optional<T>> partials(split.GetTaskCount());
+        pool.ParallelFor(split.GetTaskCount(), [&](std::size_t task) {
+            std::optional<T> partial;
+            for (std::size_t i = split.bounds[task]; i < split.bounds[task + 1]; i++) {
+                auto& segment = split.segments[i];
+                if (!partial) {
+                    partial.emplace(std::accumulate(segment.begin() + 1, segment.end(), T(segment.front()), operation));
+                }
+                else {
+                    partial.emplace(std::accumulate(segment.begin(), segment.end(), std::move(*partial), operation));
+                }
+            }
+            partials[task] = std::move(partial);
+        });
+        for (auto& partial : partials) {
+            if (partial) {
+                init = operation(std::move(init), std::move(*partial));
+            }
+        }
+        return init;
+    }
+
+    template <SegmentedList List, typename T>
+    T reduce(const List& list, T init, ThreadPool& pool = ThreadPool::Default()) {
+        return parallel::reduce(list, std::move(init), std::plus<>(), pool);
+    }
+
+    template <SegmentedList List, typename Predicate>
+    std::ptrdiff_t count_if(const List& list, Predicate predicate, ThreadPool& pool = ThreadPool::Default()) {
+        detail::WorkSplit<const List> split(list, pool);
+        std::vector<std::ptrdiff_t> counts(split.GetTaskCount());
+        pool.ParallelFor(split.GetTaskCount(), [&](std::size_t task) {
+            std::ptrdiff_t result = 0;
+            for (std::size_t i = split.bounds[task]; i < split.bounds[task + 1]; i++) {
+                result += std::count_if(split.segments[i].begin(), split.segments[i].end(), predicate);
+            }
+            counts[task] = result;
+        });
+        return std::accumulate(counts.begin(), counts.end(), std::ptrdiff_t(0));
+    }
+}
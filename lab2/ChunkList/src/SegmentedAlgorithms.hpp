@@ -0,0 +1,209 @@
+#pragma once
+#include "SimdKernels.hpp"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace fefu_laboratory_two {
+    template <typename List>
+    concept SegmentedList = requires(List& list) {
+        list.segments();
+        list.begin();
+    };
+
+    template <typename List>
+    using segment_value_t = typename std::remove_cvref_t<decltype(*std::declval<List&>().segments().begin())>::value_type;
+
+    template <typename List, typename T>
+    concept VectorizableSearch = simd::Vectorizable<segment_value_t<List>> && std::is_same_v<segment_value_t<List>, T>;
+
+    template <SegmentedList List, typename Function>
+    Function for_each(List& list, Function function) {
+        for (auto segment : list.segments()) {
+            for (auto& value : segment) {
+                function(value);
+            }
+        }
+        return function;
+    }
+
+    template <SegmentedList List, typename OutputIt>
+    OutputIt copy(const List& list, OutputIt destination) {
+        for (auto segment : list.segments()) {
+            destination = std::copy(segment.begin(), segment.end(), destination);
+        }
+        return destination;
+    }
+
+    template <SegmentedList List, typename T>
+    void fill(List& list, const T& value) {
+        for (auto segment : list.segments()) {
+            std::fill(segment.begin(), segment.end(), value);
+        }
+    }
+
+    template <SegmentedList List, typename T>
+    auto find(List& list, const T& value) {
+        std::ptrdiff_t index = 0;
+        for (auto segment : std::as_const(list).segments()) {
+            std::size_t found;
+            if constexpr (VectorizableSearch<List, T>) {
+                found = simd::Find(segment.data(), segment.size(), value);
+            }
+            else {
+                found = std::find(segment.begin(), segment.end(), value) - segment.begin();
+            }
+            if (found != segment.size()) {
+                if constexpr (requires { list.nth(0); }) {
+                    return list.nth(index + found);
+                }
+                else {
+                    return list.begin() + (index + found);
+                }
+            }
+            index += segment.size();
+        }
+        return list.end();
+    }
+
+    template <SegmentedList List, typename T>
+    std::ptrdiff_t count(const List& list, const T& value) {
+        std::ptrdiff_t result = 0;
+        for (auto segment : list.segments()) {
+            if constexpr (VectorizableSearch<List, T>) {
+                result += simd::Count(segment.data(), segment.size(), value);
+            }
+            else {
+                result += std::count(segment.begin(), segment.end(), value);
+            }
+        }
+        return result;
+    }
+
+    template <SegmentedList List, typename T, typename BinaryOperation>
+    T accumulate(const List& list, T init, BinaryOperation operation) {
+        for (auto segment : list.segments()) {
+            init = std::accumulate(segment.begin(), segment.end(), std::move(init), operation);
+        }
+        return init;
+    }
+
+    template <SegmentedList List, typename T>
+    T accumulate(const List& list, T init) {
+        return fefu_laboratory_two::accumulate(list, std::move(init), std::plus<>());
+    }
+
+    template <SegmentedList List>
+    auto sum(const List& list) {
+        using value_type = segment_value_t<List>;
+        if constexpr (simd::Vectorizable<value_type>) {
+            simd::SumType<value_type> result = 0;
+            for (auto segment : list.segments()) {
+                result += simd::Sum(segment.data(), segment.size());
+            }
+            return result;
+        }
+        else {
+            return fefu_laboratory_two::accumulate(list, value_type());
+        }
+    }
+
+    template <SegmentedList List>
+    segment_value_t<List> min(const List& list) {
+        if (list.empty()) {
+            throw std::runtime_error("empty");
+        }
+        using value_type = segment_value_t<List>;
+        const value_type* result = nullptr;
+        value_type best{};
+        for (auto segment : list.segments()) {
+            if (segment.empty()) {
+                continue;
+            }
+            if constexpr (simd::Vectorizable<value_type>) {
+                value_type candidate = simd::Min(segment.data(), segment.size());
+                if (result == nullptr || candidate < best) {
+                    best = candidate;
+                    result = &best;
+                }
+            }
+            else {
+                const value_type* candidate = &*std::min_element(segment.begin(), segment.end());
+                if (result == nullptr || *candidate < *result) {
+                    result = candidate;
+                }
+            }
+        }
+        return *result;
+    }
+
+    template <SegmentedList List>
+    segment_value_t<List> max(const List& list) {
+        if (list.empty()) {
+            throw std::runtime_error("empty");
+        }
+        using value_type = segment_value_t<List>;
+        const value_type* result = nullptr;
+        value_type best{};
+        for (auto segment : list.segments()) {
+            if (segment.empty()) {
+                continue;
+            }
+            if constexpr (simd::Vectorizable<value_type>) {
+                value_type candidate = simd::Max(segment.data(), segment.size());
+                if (result == nullptr || best < candidate) {
+                    best = candidate;
+                    result = &best;
+                }
+            }
+            else {
+                const value_type* candidate = &*std::max_element(segment.begin(), segment.end());
+                if (result == nullptr || *result < *candidate) {
+                    result = candidate;
+                }
+            }
+        }
+        return *result;
+    }
+
+    template <SegmentedList First, SegmentedList Second>
+    bool equal(const First& first, const Second& second) {
+        if (first.get_size() != second.get_size()) {
+            return false;
+        }
+        auto first_segments = first.segments();
+        auto second_segments = second.segments();
+        auto first_it = first_segments.begin();
+        auto second_it = second_segments.begin();
+        std::size_t first_offset = 0;
+        std::size_t second_offset = 0;
+        while (first_it != first_segments.end() && second_it != second_segments.end()) {
+            auto first_segment = (*first_it).subspan(first_offset);
+            auto second_segment = (*second_it).subspan(second_offset);
+            std::size_t length = std::min(first_segment.size(), second_segment.size());
+            bool same;
+            if constexpr (simd::Vectorizable<segment_value_t<First>> &&
+                          std::is_same_v<segment_value_t<First>, segment_value_t<Second>>) {
+                same = simd::Equal(first_segment.data(), length, second_segment.data());
+            }
+            else {
+                same = std::equal(first_segment.begin(), first_segment.begin() + length, second_segment.begin());
+            }
+            if (!same) {
+                return false;
+            }
+            first_offset += length;
+            second_offset += length;
+            if (first_offset == (*first_it).size()) {
+                ++first_it;
+                first_offset = 0;
+            }
+            if (second_offset == (*second_it).size()) {
+                ++second_it;
+                second_offset = 0;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,232 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define FEFU_SIMD_DISPATCH 1
+#else
+#define FEFU_SIMD_DISPATCH 0
+#endif
+
+namespace fefu_laboratory_two::simd {
+    template <typename T>
+    concept Vectorizable = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+    enum class Isa {
+        Scalar,
+        AVX2,
+        AVX512
+    };
+
+    inline Isa DetectIsa() noexcept {
+#if FEFU_SIMD_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+            return Isa::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return Isa::AVX2;
+        }
+#endif
+        return Isa::Scalar;
+    }
+
+    inline Isa ActiveIsa() noexcept {
+        static const Isa isa = DetectIsa();
+        return isa;
+    }
+
+    template <typename T>
+    using SumType = std::conditional_t<std::is_floating_point_v<T>, T,
+            std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>>;
+
+    // Kernels are written as fixed-width blocks plus a scalar tail, so the
+    // compiler vectorizes the inner loops for whichever target they are
+    // inlined into. Floating-point sums, minima and maxima are reduced
+    // lane-wise and may differ from a sequential fold in rounding and NaN
+    // handling.
+    namespace kernels {
+        template <typename T>
+        inline constexpr std::size_t block = 256 / sizeof(T);
+
+        template <typename T>
+        inline constexpr std::size_t lanes = 64 / sizeof(T);
+
+        template <typename T>
+        struct Find {
+            [[gnu::always_inline]] static inline std::size_t Run(const T* data, std::size_t count, T value) noexcept {
+                std::size_t i = 0;
+                for (; i + block<T> <= count; i += block<T>) {
+                    unsigned hit = 0;
+                    for (std::size_t j = 0; j < block<T>; j++) {
+                        hit |= data[i + j] == value;
+                    }
+                    if (hit != 0) {
+                        break;
+                    }
+                }
+                for (; i < count; i++) {
+                    if (data[i] == value) {
+                        return i;
+                    }
+                }
+                return count;
+            }
+        };
+
+        template <typename T>
+        struct Count {
+            [[gnu::always_inline]] static inline std::size_t Run(const T* data, std::size_t count, T value) noexcept {
+                std::size_t result = 0;
+                std::size_t i = 0;
+                for (; i + block<T> <= count; i += block<T>) {
+                    unsigned matches = 0;
+                    for (std::size_t j = 0; j < block<T>; j++) {
+                        matches += data[i + j] == value;
+                    }
+                    result += matches;
+                }
+                for (; i < count; i++) {
+                    result += data[i] == value;
+                }
+                return result;
+            }
+        };
+
+        template <typename T>
+        struct Sum {
+            [[gnu::always_inline]] static inline SumType<T> Run(const T* data, std::size_t count) noexcept {
+                SumType<T> partial[lanes<T>] = {};
+                std::size_t i = 0;
+                for (; i + lanes<T> <= count; i += lanes<T>) {
+                    for (std::size_t j = 0; j < lanes<T>; j++) {
+                        partial[j] += data[i + j];
+                    }
+                }
+                SumType<T> result = 0;
+                for (std::size_t j = 0; j < lanes<T>; j++) {
+                    result += partial[j];
+                }
+                for (; i < count; i++) {
+                    result += data[i];
+                }
+                return result;
+            }
+        };
+
+        template <typename T, bool Maximum>
+        struct Extremum {
+            [[gnu::always_inline]] static inline T Better(T candidate, T current) noexcept {
+                if constexpr (Maximum) {
+                    return current < candidate ? candidate : current;
+                }
+                else {
+                    return candidate < current ? candidate : current;
+                }
+            }
+
+            [[gnu::always_inline]] static inline T Run(const T* data, std::size_t count) noexcept {
+                T result = data[0];
+                std::size_t i = 0;
+                if (count >= lanes<T>) {
+                    T partial[lanes<T>];
+                    for (std::size_t j = 0; j < lanes<T>; j++) {
+                        partial[j] = data[j];
+                    }
+                    for (i = lanes<T>; i + lanes<T> <= count; i += lanes<T>) {
+                        for (std::size_t j = 0; j < lanes<T>; j++) {
+                            partial[j] = Better(data[i + j], partial[j]);
+                        }
+                    }
+                    result = partial[0];
+                    for (std::size_t j = 1; j < lanes<T>; j++) {
+                        result = Better(partial[j], result);
+                    }
+                }
+                for (; i < count; i++) {
+                    result = Better(data[i], result);
+                }
+                return result;
+            }
+        };
+
+        template <typename T>
+        struct Equal {
+            [[gnu::always_inline]] static inline bool Run(const T* first, std::size_t count, const T* second) noexcept {
+                std::size_t i = 0;
+                for (; i + block<T> <= count; i += block<T>) {
+                    unsigned differ = 0;
+                    for (std::size_t j = 0; j < block<T>; j++) {
+                        differ |= !(first[i + j] == second[i + j]);
+                    }
+                    if (differ != 0) {
+                        return false;
+                    }
+                }
+                for (; i < count; i++) {
+                    if (!(first[i] == second[i])) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        };
+
+#if FEFU_SIMD_DISPATCH
+        template <typename Kernel, typename... Args>
+        [[gnu::target("avx2")]] auto RunAvx2(Args... args) noexcept {
+            return Kernel::Run(args...);
+        }
+
+        template <typename Kernel, typename... Args>
+        [[gnu::target("avx512f,avx512bw")]] auto RunAvx512(Args... args) noexcept {
+            return Kernel::Run(args...);
+        }
+#endif
+
+        template <typename Kernel, typename... Args>
+        auto Dispatch(Args... args) noexcept {
+#if FEFU_SIMD_DISPATCH
+            switch (ActiveIsa()) {
+                case Isa::AVX512:
+                    return RunAvx512<Kernel>(args...);
+                case Isa::AVX2:
+                    return RunAvx2<Kernel>(args...);
+                default:
+                    break;
+            }
+#endif
+            return Kernel::Run(args...);
+        }
+    }
+
+    template <Vectorizable T>
+    std::size_t Find(const T* data, std::size_t count, T value) noexcept {
+        return kernels::Dispatch<kernels::Find<T>>(data, count, value);
+    }
+
+    template <Vectorizable T>
+    std::size_t Count(const T* data, std::size_t count, T value) noexcept {
+        return kernels::Dispatch<kernels::Count<T>>(data, count, value);
+    }
+
+    template <Vectorizable T>
+    SumType<T> Sum(const T* data, std::size_t count) noexcept {
+        return kernels::Dispatch<kernels::Sum<T>>(data, count);
+    }
+
+    template <Vectorizable T>
+    T Min(const T* data, std::size_t count) noexcept {
+        return kernels::Dispatch<kernels::Extremum<T, false>>(data, count);
+    }
+
+    template <Vectorizable T>
+    T Max(const T* data, std::size_t count) noexcept {
+        return kernels::Dispatch<kernels::Extremum<T, true>>(data, count);
+    }
+
+    template <Vectorizable T>
+    bool Equal(const T* first, std::size_t count, const T* second) noexcept {
+        return kernels::Dispatch<kernels::Equal<T>>(first, count, second);
+    }
+}
@@ -0,0 +1,179 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fefu_laboratory_two {
+    class ThreadPool {
+    public:
+        explicit ThreadPool(unsigned thread_count = std::max(1u, std::thread::hardware_concurrency())) {
+            thread_count = std::max(1u, thread_count);
+            for (unsigned i = 0; i < thread_count; i++) {
+                queues.push_back(std::make_unique<Queue>());
+            }
+            for (unsigned i = 1; i < thread_count; i++) {
+                threads.emplace_back([this, i] { WorkerLoop(i); });
+            }
+        }
+
+        ThreadPool(const ThreadPool& other) = delete;
+
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        }
+
+        static ThreadPool& Default() {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        unsigned GetThreadCount() const noexcept {
+            return static_cast<unsigned>(queues.size());
+        }
+
+        // Runs function(0) ... function(count - 1) and returns once all of them
+        // have finished. The calling thread executes queued tasks while it
+        // waits, so nested calls from inside a task do not deadlock. The first
+        // exception thrown by a task is rethrown here.
+        template <typename Function>
+        void ParallelFor(std::size_t count, Function&& function) {
+            if (count == 0) {
+                return;
+            }
+            if (queues.size() == 1 || count == 1) {
+                for (std::size_t i = 0; i < count; i++) {
+                    function(i);
+                }
+                return;
+            }
+            Batch batch;
+            batch.remaining = count;
+            unsigned self = Self();
+            std::size_t published = 0;
+            std::exception_ptr failure;
+            try {
+                for (; published < count; published++) {
+                    Queue& queue = *queues[(self + published) % queues.size()];
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    queue.tasks.emplace_back([&batch, &function, i = published] {
+                        try {
+                            function(i);
+                        }
+                        catch (...) {
+                            std::lock_guard<std::mutex> error_lock(batch.mutex);
+                            if (!batch.error) {
+                                batch.error = std::current_exception();
+                            }
+                        }
+                        batch.remaining.fetch_sub(1, std::memory_order_acq_rel);
+                    });
+                }
+            }
+            catch (...) {
+                // The tasks queued so far refer to batch and function, so they
+                // must finish before this frame unwinds.
+                failure = std::current_exception();
+                batch.remaining.fetch_sub(count - published, std::memory_order_acq_rel);
+            }
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+                pending += static_cast<std::ptrdiff_t>(published);
+            }
+            wake.notify_all();
+            while (batch.remaining.load(std::memory_order_acquire) > 0) {
+                if (!TryRunOne(self)) {
+                    std::this_thread::yield();
+                }
+            }
+            if (failure) {
+                std::rethrow_exception(failure);
+            }
+            if (batch.error) {
+                std::rethrow_exception(batch.error);
+            }
+        }
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        struct Batch {
+            std::atomic<std::size_t> remaining = 0;
+            std::mutex mutex;
+            std::exception_ptr error;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        std::atomic<std::ptrdiff_t> pending = 0;
+        bool stopping = false;
+
+        static inline thread_local const ThreadPool* current_pool = nullptr;
+        static inline thread_local unsigned current_index = 0;
+
+        unsigned Self() const noexcept {
+            return current_pool == this ? current_index : 0;
+        }
+
+        bool TryRunOne(unsigned self) {
+            std::function<void()> task;
+            for (std::size_t k = 0; k < queues.size() && !task; k++) {
+                Queue& queue = *queues[(self + k) % queues.size()];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (queue.tasks.empty()) {
+                    continue;
+                }
+                if (k == 0) {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                }
+                else {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+            }
+            if (!task) {
+                return false;
+            }
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            return true;
+        }
+
+        void WorkerLoop(unsigned index) {
+            current_pool = this;
+            current_index = index;
+            while (true) {
+                if (TryRunOne(index)) {
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleep_mutex);
+                wake.wait(lock, [this] { return stopping || pending.load(std::memory_order_relaxed) > 0; });
+                if (stopping && pending.load(std::memory_order_relaxed) <= 0) {
+                    return;
+                }
+            }
+        }
+    };
+}